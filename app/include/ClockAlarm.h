@@ -5,20 +5,26 @@
 #ifndef __CLOCK_ALARM_H
 #define __CLOCK_ALARM_H
 
-#include <zephyr/sys/printk.h>
+#include <zephyr/logging/log.h>
 
 #include <zephyr/device.h>
 
 #include <ClockGong.h>
+#include <ClockMetrics.h>
 #include <ClockSettings.h>
 #include <ClockTime.h>
+#include <ClockWatchdog.h>
 
 class ClockAlarm
 {
     public:
         ClockAlarm(ClockSettings *clockSettings, ClockTime *clockTime);
 
-        void process();
+        //the main loop, it feeds the watchdog channel of the thread
+        void process(ClockWatchdog *watchdog);
+
+        //plays the alarm signal
+        void processAlarm();
 
     private:
         ClockSettings *clockSettings;
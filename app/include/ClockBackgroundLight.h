@@ -5,7 +5,7 @@
 #ifndef __CLOCK_BACKGROUND_LIGHT_H
 #define __CLOCK_BACKGROUND_LIGHT_H
 
-#include <zephyr/sys/printk.h>
+#include <zephyr/logging/log.h>
 
 #include <zephyr/device.h>
 #include <zephyr/devicetree.h>
@@ -13,6 +13,9 @@
 #include <zephyr/drivers/gpio.h>
 
 #include <ClockDisplay.h>
+#include <ClockEventLoop.h>
+#include <ClockMetrics.h>
+#include <ClockWatchdog.h>
 
 class ClockBackgroundLight
 {
@@ -25,8 +28,11 @@ class ClockBackgroundLight
         //sets the background light for the buttons
         void set(bool onOff);
 
-        //the main loop
-        void process();
+        //the main loop, it feeds the watchdog channel of the thread
+        void process(ClockWatchdog *watchdog);
+
+        //shows the background light change
+        void processChange();
 
 
     private:
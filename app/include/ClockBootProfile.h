@@ -0,0 +1,60 @@
+/*
+ * The class that records the boot time of the clock init stages
+ * 
+ */
+#ifndef __CLOCK_BOOT_PROFILE_H
+#define __CLOCK_BOOT_PROFILE_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+/**
+ * Every init stage stores the hardware cycle counter when it ends.
+ * The counter starts with the system clock, so the first stage also shows the time before main().
+ * It does nothing if CONFIG_APP_BOOT_PROFILE is not set.
+ */
+class ClockBootProfile
+{
+    public:
+        //the init stages in the boot order
+        static const uint8_t stageMain = 0;
+        static const uint8_t stageSettings = 1;
+        static const uint8_t stageTime = 2;
+        static const uint8_t stageTemperature = 3;
+        static const uint8_t stageDisplay = 4;
+        static const uint8_t stageFirstFrame = 5;
+        static const uint8_t stageThreads = 6;
+        static const uint8_t numberOfStages = 7;
+
+        /**
+         * Stores the cycle counter for the end of the stage
+         *
+         * @param uint8_t stage The init stage
+         */
+        static inline void mark(uint8_t stage)
+        {
+            if (!IS_ENABLED(CONFIG_APP_BOOT_PROFILE) || (stage >= numberOfStages)) {
+                return;
+            }
+
+            stamps[stage] = k_cycle_get_32();
+            markedStages |= BIT(stage);
+        }
+
+        /**
+         * Prints the time from the boot and the time of every stage
+         */
+        static void dump();
+
+    private:
+        //the stage names for the dump
+        static const char *const stageNames[];
+
+        //the cycle counter at the end of every stage
+        static uint32_t stamps[];
+
+        //the stages that were marked
+        static uint32_t markedStages;
+};
+
+#endif
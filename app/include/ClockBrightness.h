@@ -0,0 +1,99 @@
+/*
+ * The class that controls the display brightness from the light level
+ * 
+ */
+#ifndef __CLOCK_BRIGHTNESS_H
+#define __CLOCK_BRIGHTNESS_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+/**
+ * The light level is converted to a logarithmic index: 8 steps for every doubling of the light.
+ * The index is smoothed with an exponential filter and mapped to the display level
+ * through a table generated at compile time.
+ * The level changes only when the filtered index is a hysteresis band past the level boundary,
+ * so the light near a boundary does not switch the level back and forth.
+ */
+class ClockBrightness
+{
+    public:
+        //the number of the logarithmic indexes, it covers the whole uint32_t milli lux range
+        static const uint16_t numberOfIndexes = 256;
+
+        //the number of the display levels, the HT1632C has 16 PWM levels
+        static const uint8_t numberOfLevels = 16;
+
+        /**
+         * Converts the light level to the logarithmic index
+         * The index is 8 * log2(milliLux) with the fraction taken from the 3 bits below the highest bit
+         *
+         * @param uint32_t milliLux The light level in milli lux
+         *
+         * @return uint8_t The index
+         */
+        static constexpr uint8_t getIndex(uint32_t milliLux)
+        {
+            if (milliLux == 0) {
+                return 0;
+            }
+
+            uint8_t highestBit = 31 - __builtin_clz(milliLux);
+
+            uint8_t fraction = (highestBit >= 3) ? ((milliLux >> (highestBit - 3)) & 0x07)
+                : ((milliLux << (3 - highestBit)) & 0x07);
+
+            return (highestBit << 3) | fraction;
+        }
+
+        /**
+         * Adds the light level to the filter
+         *
+         * @param uint32_t milliLux The light level in milli lux
+         *
+         * @return bool True if the display level changed
+         */
+        bool update(uint32_t milliLux);
+
+        /**
+         * Gets the display brightness between 0 and 255
+         */
+        uint8_t getBrightness();
+
+        /**
+         * Checks if the filter reached the last light level
+         */
+        bool isSettled();
+
+        /**
+         * Gets the light sensor power saving mode
+         * The sensor measures fast while the light is changing and saves power when it is stable.
+         *
+         * @return uint8_t 0 without the power saving, 1-4 for the power saving modes
+         */
+        uint8_t getPowerSavingMode();
+
+    private:
+        //the filter keeps the index multiplied by 2^filterScale
+        static const uint8_t filterScale = 4;
+
+        //the new index is added with the weight 1/2^filterShift
+        static const uint8_t filterShift = 2;
+
+        //the filtered index must pass the level boundary by this number of indexes, a half of the light doubling
+        static const uint8_t hysteresis = 4;
+
+        //the filtered index multiplied by 2^filterScale
+        uint16_t filteredIndex = 0;
+
+        //the index of the last light level
+        uint8_t lastIndex = 0;
+
+        //the current display level
+        uint8_t level = 0;
+
+        //the filter has the first sample
+        bool ready = false;
+};
+
+#endif
@@ -5,7 +5,9 @@
 #ifndef __CLOCK_BUTTONS_H
 #define __CLOCK_BUTTONS_H
 
-#include <zephyr/sys/printk.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/logging/log.h>
 
 #include <zephyr/device.h>
 #include <zephyr/devicetree.h>
@@ -13,18 +15,12 @@
 #include <zephyr/drivers/gpio.h>
 
 #include <ClockDisplay.h>
+#include <ClockEventLoop.h>
+#include <ClockLatency.h>
+#include <ClockMetrics.h>
 #include <ClockTime.h>
 #include <ClockTimezone.h>
-
-/**
- * FIFO to store the list of pressed buttons
- */
-struct pressedButton {
-    /* 1st word reserved for use by FIFO */
-    void *fifoReserved;
-    uint8_t id;
-};
-
+#include <ClockWatchdog.h>
 
 class ClockButtons
 {
@@ -32,14 +28,18 @@ class ClockButtons
 
         ClockButtons(ClockSettings *clockSettings, ClockTime *clockTime, ClockDisplay *clockDisplay);
 
-        void processButtonActions();
+        //the main loop, it feeds the watchdog channel of the thread
+        void processButtonActions(ClockWatchdog *watchdog);
+
+        //processes every press of the buttons in the order of their IDs
+        void processPressedButtons();
 
     private:
 
         /**
-         * FIFO to store clicked buttons events for further processing
+         * Wakes up the buttons thread after a press
          */
-        static struct k_fifo pressedButtons;
+        static struct k_sem pressedSemaphore;
 
         /**
          * The last time a button was pressed. For debouncing
@@ -68,6 +68,13 @@ class ClockButtons
         static const uint8_t dateButtonId = 4;
         static const uint8_t memoButtonId = 5;
         static const uint8_t tempButtonId = 6;
+
+        /**
+         * The presses of every button waiting for the processing, the index is the button ID.
+         * The interrupt only adds a press, so the repeated presses before the thread runs are all processed
+         * and nothing points to the interrupt stack.
+         */
+        static atomic_t pressedCounts[tempButtonId + 1];
         
 
         static struct gpio_callback hButtonCallbackData;
@@ -98,90 +105,69 @@ class ClockButtons
         int initButtonInterrupt(const struct gpio_dt_spec *button, struct gpio_callback *callback, 
             gpio_callback_handler_t callbackFunction);
 
-        static inline void hButtonPressed(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
+        /**
+         * Stores the pressed button and wakes up the thread or the event loop
+         */
+        static inline void buttonPressed(const uint8_t pressedButtonId, const struct device *dev, uint32_t pins)
         {
-            struct pressedButton eventPressedButton;
-            eventPressedButton.id = hButtonId;
+            LOG_MODULE_DECLARE(clock_buttons, CONFIG_APP_BUTTONS_LOG_LEVEL);
 
-            if (buttonDebouncer(eventPressedButton.id)) {
-                printk("The button was debounced, ID: %u\n", eventPressedButton.id);
+            ClockMetrics::count(ClockMetrics::counterButtonEvents);
+
+            if (buttonDebouncer(pressedButtonId)) {
+                ClockMetrics::count(ClockMetrics::counterButtonDebounced);
+                LOG_DBG("The button was debounced, ID: %u", pressedButtonId);
                 return;
             }
 
-            k_fifo_put(&pressedButtons, &eventPressedButton);
-            printk("Button pressed: %s, pins: %zu, ID: %u\n", dev->name, pins, eventPressedButton.id);
-        }
+            ClockLatency::start();
 
-        static inline void minButtonPressed(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
-        {
-            struct pressedButton eventPressedButton;
-            eventPressedButton.id = minButtonId;
+            atomic_inc(&pressedCounts[pressedButtonId]);
 
-            if (buttonDebouncer(eventPressedButton.id)) {
-                printk("The button was debounced, ID: %u\n", eventPressedButton.id);
-                return;
+            if (IS_ENABLED(CONFIG_APP_EVENT_LOOP)) {
+                ClockEventLoop::post(ClockEventLoop::eventButton);
+            } else {
+                k_sem_give(&pressedSemaphore);
             }
 
-            k_fifo_put(&pressedButtons, &eventPressedButton);
-            printk("Button pressed: %s, pins: %zu, ID: %u\n", dev->name, pins, eventPressedButton.id);
+            LOG_DBG("Button pressed: %s, pins: %zu, ID: %u", dev->name, pins, pressedButtonId);
         }
 
-        static inline void hourButtonPressed(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
+        static inline void hButtonPressed(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
         {
-            struct pressedButton eventPressedButton;
-            eventPressedButton.id = hourButtonId;
+            buttonPressed(hButtonId, dev, pins);
+        }
 
-            if (buttonDebouncer(eventPressedButton.id)) {
-                printk("The button was debounced, ID: %u\n", eventPressedButton.id);
-                return;
-            }
+        static inline void minButtonPressed(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
+        {
+            buttonPressed(minButtonId, dev, pins);
+        }
 
-            k_fifo_put(&pressedButtons, &eventPressedButton);
-            printk("Button pressed: %s, pins: %zu, ID: %u\n", dev->name, pins, eventPressedButton.id);
+        static inline void hourButtonPressed(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
+        {
+            buttonPressed(hourButtonId, dev, pins);
         }
 
         static inline void dateButtonPressed(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
         {
-            struct pressedButton eventPressedButton;
-            eventPressedButton.id = dateButtonId;
-
-            if (buttonDebouncer(eventPressedButton.id)) {
-                printk("The button was debounced, ID: %u\n", eventPressedButton.id);
-                return;
-            }
-
-            k_fifo_put(&pressedButtons, &eventPressedButton);
-            printk("Button pressed: %s, pins: %zu, ID: %u\n", dev->name, pins, eventPressedButton.id);
+            buttonPressed(dateButtonId, dev, pins);
         }
 
         static inline void memoButtonPressed(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
         {
-            struct pressedButton eventPressedButton;
-            eventPressedButton.id = memoButtonId;
-
-            if (buttonDebouncer(eventPressedButton.id)) {
-                printk("The button was debounced, ID: %u\n", eventPressedButton.id);
-                return;
-            }
-
-            k_fifo_put(&pressedButtons, &eventPressedButton);
-            printk("Button pressed: %s, pins: %zu, ID: %u\n", dev->name, pins, eventPressedButton.id);
+            buttonPressed(memoButtonId, dev, pins);
         }
 
         static inline void tempButtonPressed(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
         {
-            struct pressedButton eventPressedButton;
-            eventPressedButton.id = tempButtonId;
-
-            if (buttonDebouncer(eventPressedButton.id)) {
-                printk("The button was debounced, ID: %u\n", eventPressedButton.id);
-                return;
-            }
-
-            k_fifo_put(&pressedButtons, &eventPressedButton);
-            printk("Button pressed: %s, pins: %zu, ID: %u\n", dev->name, pins, eventPressedButton.id);
+            buttonPressed(tempButtonId, dev, pins);
         }
 
+        /**
+         * Processes one press of the button
+         */
+        void processPressedButton(uint8_t id);
+
         void hButtonProcess(void);
 
         void minButtonProcess(void);
@@ -5,7 +5,8 @@
 #ifndef __CLOCK_DISPLAY_H
 #define __CLOCK_DISPLAY_H
 
-#include <zephyr/sys/printk.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/logging/log.h>
 
 #include <zephyr/device.h>
 #include <zephyr/devicetree.h>
@@ -17,6 +18,9 @@
 #include <string.h>
 #include <stdlib.h>
 
+#include <ClockEventLoop.h>
+#include <ClockLatency.h>
+#include <ClockMetrics.h>
 #include <ClockTemperature.h>
 #include <ClockTime.h>
 #include <ClockTimeLib.h>
@@ -33,6 +37,11 @@ class ClockDisplay
         static const uint8_t modeDate = 1;
         static const uint8_t modeTemp = 2;
 
+        //the temperature statistics of the trip
+        static const uint8_t modeTempMin = 3;
+        static const uint8_t modeTempMax = 4;
+        static const uint8_t modeTempTrend = 5;
+
         //setting the time modes
         static const uint8_t modeYear = 10;
         static const uint8_t modeMonth = 11;
@@ -70,14 +79,33 @@ class ClockDisplay
         struct k_mutex mutexDisplay;
 
 
-        ClockDisplay(ClockSettings *clockSettings, ClockTime *clockTime, ClockTemperature *clockTemperature);
+        ClockDisplay(ClockSettings *clockSettings, ClockTime *clockTime, ClockTemperature *clockTemperature,
+            ClockLightSensor *clockLightSensor);
 
         //show different screens depending on the mode
         void show(bool showTitle = true);
 
+        //the brightness is set from the light level, there is no override
+        static const int16_t brightnessAutomatic = -1;
+
         //sets the brightness level from luxes
         void setBrightness(uint8_t lux);
 
+        /**
+         * Sets the brightness that replaces the one from the light level
+         *
+         * @param int16_t brightness The brightness between 0 and 255 or brightnessAutomatic to remove the override
+         */
+        void setBrightnessOverride(int16_t brightness);
+
+        /**
+         * Gets the brightness override or brightnessAutomatic if there is none
+         */
+        int16_t inline getBrightnessOverride()
+        {
+            return (int16_t)atomic_get(&brightnessOverride);
+        }
+
         //sets the background light for the buttons
         void setBackgroundLight(bool onOff);
 
@@ -116,7 +144,11 @@ class ClockDisplay
          */
         void inline wakeup()
         {
-            k_wakeup(this->threadId);
+            if (IS_ENABLED(CONFIG_APP_EVENT_LOOP)) {
+                ClockEventLoop::post(ClockEventLoop::eventDisplay);
+            } else {
+                k_wakeup(this->threadId);
+            }
         }
         
         /**
@@ -136,9 +168,23 @@ class ClockDisplay
         //the clockTemperature object
         ClockTemperature *clockTemperature;
 
+        //the clockLightSensor object shared with the brightness thread
+        ClockLightSensor *clockLightSensor;
+
         //saves the current thread ID
         k_tid_t threadId;
 
+        //the brightness from the light level, it is restored when the override is removed
+        uint8_t automaticBrightness = 0;
+
+        //the brightness set from the shell or brightnessAutomatic
+        atomic_t brightnessOverride = ATOMIC_INIT(brightnessAutomatic);
+
+        /**
+         * Writes the brightness to the display
+         */
+        void writeBrightness(uint8_t brightness);
+
         //the previous operating mode of the display: time, date, temperature
         uint8_t previousMode = 0;
 
@@ -185,6 +231,14 @@ class ClockDisplay
          */
         void drawString(const char *displayStr);
 
+        /**
+         * Converts the temperature from the tenths of a degree Celsius to the whole degrees of the selected format
+         *
+         * @param int temperature The temperature in tenths of a degree Celsius
+         * @param bool difference The temperature is a difference, so there is no Fahrenheit offset
+         */
+        int convertTemperature(int temperature, bool difference = false);
+
         /**
          * Draws and displays the string scrolling it to the left
          */
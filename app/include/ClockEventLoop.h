@@ -0,0 +1,57 @@
+/*
+ * The class for the event loop that runs all the clock tasks in one thread
+ * 
+ */
+#ifndef __CLOCK_EVENT_LOOP_H
+#define __CLOCK_EVENT_LOOP_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/logging/log.h>
+
+/**
+ * With CONFIG_APP_EVENT_LOOP the interrupts and the callbacks set the event bits
+ * instead of waking up their own threads. The display thread takes all the pending bits at once
+ * and runs the handlers in the order of the bits, so the order is always the same.
+ * Without CONFIG_APP_EVENT_LOOP post() does nothing.
+ */
+class ClockEventLoop
+{
+    public:
+        //the events in the order of the handlers
+        static const uint32_t eventButton = BIT(0);
+        static const uint32_t eventAlarm = BIT(1);
+        static const uint32_t eventBackgroundLight = BIT(2);
+        static const uint32_t eventLight = BIT(3);
+        static const uint32_t eventDisplay = BIT(4);
+
+        /**
+         * Inits the event loop, it must be called before the interrupts are enabled
+         */
+        static void init();
+
+        /**
+         * Sets the event bits and wakes up the loop, it can be called from an interrupt
+         *
+         * @param uint32_t events The event bits
+         */
+        static void post(uint32_t events);
+
+        /**
+         * Waits for the events and takes all the pending ones
+         *
+         * @param k_timeout_t timeout The longest wait
+         *
+         * @return uint32_t The event bits, 0 on the timeout
+         */
+        static uint32_t wait(k_timeout_t timeout);
+
+    private:
+        //the pending event bits
+        static atomic_t pending;
+
+        //wakes up the loop when an event is posted
+        static struct k_sem wake;
+};
+
+#endif
@@ -5,7 +5,7 @@
 #ifndef __CLOCK_GONG_H
 #define __CLOCK_GONG_H
 
-#include <zephyr/sys/printk.h>
+#include <zephyr/logging/log.h>
 
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
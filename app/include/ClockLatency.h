@@ -0,0 +1,130 @@
+/*
+ * The class that traces the latency from a button press to the display update
+ *
+ */
+#ifndef __CLOCK_LATENCY_H
+#define __CLOCK_LATENCY_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/shell/shell.h>
+
+#include <soc.h>
+
+/**
+ * The button interrupt starts a trace, then every stage on the way to the display stores
+ * the DWT cycle counter once. The display write ends the trace and the cycles from the interrupt
+ * to every stage are added to a ring buffer of the last traces.
+ * Only the thread that processed the button marks the later stages,
+ * so the display refresh of another thread does not end the trace.
+ * It does nothing if CONFIG_APP_LATENCY_TRACE is not set.
+ */
+class ClockLatency
+{
+    public:
+        //the stages in the order of the button processing
+        static const uint8_t stageInterrupt = 0;
+        static const uint8_t stageButtons = 1;
+        static const uint8_t stageShow = 2;
+        static const uint8_t stageRender = 3;
+        static const uint8_t stageWritten = 4;
+        static const uint8_t numberOfStages = 5;
+
+        /**
+         * Starts the DWT cycle counter
+         */
+        static void init();
+
+        /**
+         * Starts a trace, it is called from the button interrupt
+         */
+        static inline void start()
+        {
+            if (!IS_ENABLED(CONFIG_APP_LATENCY_TRACE)) {
+                return;
+            }
+
+            //the trace in progress is not restarted by the next press,
+            //unless it did not reach the display in a second
+            if (atomic_cas(&active, 0, 1) || ((getCycles() - stamps[stageInterrupt]) > SystemCoreClock)) {
+                stamps[stageInterrupt] = getCycles();
+                markedStages = BIT(stageInterrupt);
+            }
+        }
+
+        /**
+         * Stores the cycle counter for the stage of the trace in progress
+         *
+         * @param uint8_t stage The stage
+         */
+        static inline void mark(uint8_t stage)
+        {
+            //the display refresh without a trace costs only this check
+            if (!IS_ENABLED(CONFIG_APP_LATENCY_TRACE) || !atomic_get(&active)) {
+                return;
+            }
+
+            markStage(stage, getCycles());
+        }
+
+        /**
+         * Prints the percentiles of the time from the interrupt to every stage
+         */
+        static void dump(const struct shell *sh);
+
+        /**
+         * Clears the stored traces
+         */
+        static void reset();
+
+    private:
+        //the stage names for the dump
+        static const char *const stageNames[numberOfStages];
+
+        //a trace is in progress
+        static atomic_t active;
+
+        //the cycle counter at every stage of the trace in progress
+        static uint32_t stamps[numberOfStages];
+
+        //the stages of the trace in progress that were marked
+        static uint32_t markedStages;
+
+        //the thread that processes the button of the trace in progress
+        static k_tid_t traceThread;
+
+#ifdef CONFIG_APP_LATENCY_TRACE
+        //the cycles from the interrupt to every later stage of the last traces
+        static uint32_t samples[CONFIG_APP_LATENCY_TRACE_SAMPLES][numberOfStages - 1];
+#endif
+
+        //the number of the stored traces
+        static uint16_t numberOfSamples;
+
+        //the place of the next trace in the ring buffer
+        static uint16_t nextSample;
+
+        //guards the ring buffer
+        static struct k_spinlock lock;
+
+        /**
+         * Gets the DWT cycle counter, it counts the CPU clock
+         */
+        static inline uint32_t getCycles()
+        {
+            return DWT->CYCCNT;
+        }
+
+        /**
+         * Stores the stage and adds the trace to the ring buffer after the display write
+         */
+        static void markStage(uint8_t stage, uint32_t cycles);
+
+        /**
+         * Converts the cycles to us
+         */
+        static uint32_t toMicroseconds(uint32_t cycles);
+};
+
+#endif
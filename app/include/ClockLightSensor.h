@@ -5,41 +5,109 @@
 #ifndef __CLOCK_LIGHT_SENSOR_H
 #define __CLOCK_LIGHT_SENSOR_H
 
-#include <zephyr/sys/printk.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
 
 #include <zephyr/device.h>
 #include <zephyr/devicetree.h>
 #include <zephyr/drivers/sensor.h>
 #include <zephyr/drivers/i2c.h>
 
-struct ClockLightBrightness {
-    //from 0 to 255
-    uint8_t brightness;
-    //from the light value in Lux
-    uint32_t from;
-    //to the light value in Lux
-    uint32_t to;
-};
+#include <driver_veml7700.h>
+
+#include <ClockEventLoop.h>
+#include <ClockMetrics.h>
 
+/**
+ * The only owner of the VEML7700, it is created once and shared by the threads.
+ * The last sample is cached with its time. The sensor has a new measurement only once
+ * per its refresh period, so a reader inside the period gets the cached sample without the I2C transfer.
+ */
 class ClockLightSensor
 {
     public:
         ClockLightSensor();
 
-        //get the light value in luxes
-        uint32_t getLightLux();
+        //get the light value in milli luxes
+        uint32_t getLightMilliLux();
+
+        /**
+         * Sets the threshold window around the last light value and waits until the light leaves it
+         *
+         * @param k_timeout_t timeout The longest wait
+         *
+         * @return bool True if the light changed, false on the timeout
+         */
+        bool waitForChange(k_timeout_t timeout);
+
+        /**
+         * Sets the threshold window around the last light value and the trigger without waiting
+         * The trigger posts the light event to the event loop.
+         *
+         * @return int 0 on success or negative error code
+         */
+        int startWatch();
+
+        /**
+         * Disables the threshold trigger
+         */
+        void stopWatch();
 
-        //get the light brightness using the lookup table
-        uint8_t getBrightness();
+        /**
+         * Sets the power saving mode of the sensor, it is written only when it changes
+         *
+         * @param uint8_t mode 0 disables the power saving, 1-4 select the mode with the longer refresh time
+         *
+         * @return int 0 on success or negative error code
+         */
+        int setPowerSaving(uint8_t mode);
 
     private:
-        //the light sensor device
-        const struct device *sensor;
+        //the threshold window is the last light value plus and minus 1/2^thresholdShift of it
+        const static uint8_t thresholdShift = 3;
+
+        //the smallest half width of the threshold window in milli luxes
+        const static uint16_t thresholdMinimum = 20;
+
+        //the refresh period in ms if the sensor does not report it
+        const static uint16_t defaultRefreshPeriod = 100;
+
+        //the last light value in milli luxes
+        uint32_t lastLight = 0;
 
-        //the Lux light value to the brightness(0-255) lookup table
-        const static ClockLightBrightness brightnessLookupTable[16];
+        //the uptime of the last sample in ms
+        int64_t lastSampleTime = 0;
 
+        //the last sample is valid
+        bool sampleReady = false;
+
+        //the power saving mode set in the sensor, 0xff if it is unknown
+        uint8_t powerSavingMode = 0xff;
+
+        //the sample fetch and the trigger setup use the sensor
+        struct k_mutex mutexSensor;
+
+        //given by the sensor trigger when the light leaves the threshold window
+        struct k_sem lightChanged;
+
+        //the instance that waits for the trigger
+        static ClockLightSensor *waitingSensor;
+
+        //the threshold trigger callback
+        static void thresholdTriggered(const struct device *dev, const struct sensor_trigger *trigger);
+
+        /**
+         * Gets the time between the measurements of the sensor in ms, it changes with the integration time
+         */
+        uint32_t getRefreshPeriod();
+
+        /**
+         * Fetches the new sample from the sensor into the cache
+         */
+        int fetch();
+
+        //the light sensor device
+        const struct device *sensor;
 };
 
 #endif
-
@@ -0,0 +1,155 @@
+/*
+ * The class for the runtime counters and histograms of the clock
+ *
+ */
+#ifndef __CLOCK_METRICS_H
+#define __CLOCK_METRICS_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/logging/log.h>
+
+#include <string.h>
+
+/**
+ * The count, the sum and the smallest and the largest of the recorded values
+ */
+struct ClockMetricsHistogram {
+    uint32_t count;
+    uint64_t sum;
+    uint32_t minimum;
+    uint32_t maximum;
+};
+
+/**
+ * The counters are atomic, so they can be counted from the interrupts.
+ * The histograms are updated under a spinlock, it is held only for a few instructions.
+ * The RTC and the light sensor drivers count every I2C transaction through their hooks,
+ * the EEPROM transactions are counted for every driver call, a call may send several messages.
+ * It does nothing if CONFIG_APP_METRICS is not set.
+ */
+class ClockMetrics
+{
+    public:
+        //the counters
+        static const uint8_t counterI2cRtc = 0;
+        static const uint8_t counterI2cLightSensor = 1;
+        static const uint8_t counterI2cEeprom = 2;
+        static const uint8_t counterRtcReads = 3;
+        static const uint8_t counterEepromWrites = 4;
+        static const uint8_t counterDisplayWrites = 5;
+        static const uint8_t counterDisplayBytes = 6;
+        static const uint8_t counterButtonEvents = 7;
+        static const uint8_t counterButtonDebounced = 8;
+        static const uint8_t counterWakeups = 9;
+        static const uint8_t counterMutexTimeouts = 10;
+        static const uint8_t numberOfCounters = 11;
+
+        //the histograms
+        static const uint8_t histogramDisplayWriteTime = 0;
+        static const uint8_t histogramRtcReadTime = 1;
+        static const uint8_t histogramEepromWriteTime = 2;
+        static const uint8_t histogramWakeupsPerHour = 3;
+        static const uint8_t numberOfHistograms = 4;
+
+        /**
+         * Adds to the counter, it can be called from an interrupt
+         *
+         * @param uint8_t counter The counter
+         * @param uint32_t value The value to add
+         */
+        static inline void count(uint8_t counter, uint32_t value = 1)
+        {
+            if (!IS_ENABLED(CONFIG_APP_METRICS) || (counter >= numberOfCounters)) {
+                return;
+            }
+
+            atomic_add(&counters[counter], value);
+        }
+
+        /**
+         * Adds the value to the histogram
+         *
+         * @param uint8_t histogram The histogram
+         * @param uint32_t value The value
+         */
+        static void record(uint8_t histogram, uint32_t value);
+
+        /**
+         * Gets the cycle counter for the start of a timed operation
+         */
+        static inline uint32_t startTimer()
+        {
+            return IS_ENABLED(CONFIG_APP_METRICS) ? k_cycle_get_32() : 0;
+        }
+
+        /**
+         * Adds the time in us since the start of the operation to the histogram
+         *
+         * @param uint8_t histogram The histogram
+         * @param uint32_t start The cycle counter from startTimer()
+         */
+        static inline void recordTime(uint8_t histogram, uint32_t start)
+        {
+            if (!IS_ENABLED(CONFIG_APP_METRICS)) {
+                return;
+            }
+
+            //the cycle difference is correct across a counter wrap
+            record(histogram, k_cyc_to_us_floor32(k_cycle_get_32() - start));
+        }
+
+        /**
+         * Counts a thread wakeup, the wakeups of every hour go to the histogram
+         */
+        static void countWakeup();
+
+        /**
+         * Gets the value of the counter
+         */
+        static uint32_t getCounter(uint8_t counter);
+
+        /**
+         * Gets a copy of the histogram
+         */
+        static ClockMetricsHistogram getHistogram(uint8_t histogram);
+
+        /**
+         * Gets the name of the counter for the dump
+         */
+        static const char *getCounterName(uint8_t counter);
+
+        /**
+         * Gets the name of the histogram for the dump
+         */
+        static const char *getHistogramName(uint8_t histogram);
+
+        /**
+         * Clears all the counters and the histograms
+         */
+        static void reset();
+
+    private:
+        //the counter names for the dump
+        static const char *const counterNames[numberOfCounters];
+
+        //the histogram names for the dump
+        static const char *const histogramNames[numberOfHistograms];
+
+        //the counters
+        static atomic_t counters[numberOfCounters];
+
+        //the histograms
+        static ClockMetricsHistogram histograms[numberOfHistograms];
+
+        //guards the histograms and the wakeups of the current hour
+        static struct k_spinlock lock;
+
+        //the uptime hour of the counted wakeups
+        static uint32_t wakeupHour;
+
+        //the wakeups in the current hour
+        static uint32_t hourWakeups;
+};
+
+#endif
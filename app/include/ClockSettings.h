@@ -5,7 +5,10 @@
 #ifndef __CLOCK_SETTINGS_H
 #define __CLOCK_SETTINGS_H
 
-#include <zephyr/sys/printk.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/logging/log.h>
+
+#include <string.h>
 
 #include <zephyr/device.h>
 #include <zephyr/devicetree.h>
@@ -15,8 +18,50 @@
 
 #include <zephyr/drivers/gpio.h>
 
+#include <zephyr/settings/settings.h>
+
+#include <ClockMetrics.h>
+#include <ClockSettingsLog.h>
 #include <ClockTimezone.h>
 
+/**
+ * The settings record version 1 is the image of the whole settings object of the old firmware
+ * with the natural alignment of the fields
+ */
+struct ClockSettingsRecordV1 {
+    TimeChangeRule dstRule;
+    TimeChangeRule stdRule;
+    bool hourlyAlarm;
+    uint8_t formatTemperature;
+    uint8_t formatHour;
+    //must be 0x4322
+    uint32_t settingsId;
+};
+
+/**
+ * The time change rule as it is stored in the EEPROM
+ */
+struct ClockSettingsRuleRecord {
+    char abbrev[6];
+    uint8_t week;
+    uint8_t dow;
+    uint8_t month;
+    uint8_t hour;
+    //offset from UTC in minutes
+    int16_t offset;
+} __attribute__((packed));
+
+/**
+ * The settings record version 2 holds only the data without padding
+ */
+struct ClockSettingsRecord {
+    ClockSettingsRuleRecord dstRule;
+    ClockSettingsRuleRecord stdRule;
+    uint8_t hourlyAlarm;
+    uint8_t formatTemperature;
+    uint8_t formatHour;
+} __attribute__((packed));
+
 class ClockSettings
 {
     public:
@@ -49,20 +94,60 @@ class ClockSettings
         ClockSettings();
 
         /**
-         * Loads the variables of the class from the EEPROM
+         * Loads all keys that are not loaded yet from the settings storage
         */
         int load();
 
         /**
-         * Saves the variables of the class  into the EEPROM
+         * Saves the keys that changed since they were loaded or saved into the settings storage
+         *
+         * @return 0 or the negative error code of the last key that was not saved
          */
         int save();
 
+        /**
+         * Gets the daylight time start rule
+         */
+        inline TimeChangeRule *getDstRule()
+        {
+            ensureLoaded(keyDst);
+            return &dstRule;
+        }
+
+        /**
+         * Gets the standard time start rule
+         */
+        inline TimeChangeRule *getStdRule()
+        {
+            ensureLoaded(keyStd);
+            return &stdRule;
+        }
+
+        /**
+         * Gets how to show temperature: Celsius or Fahrenheit
+         */
+        inline uint8_t getFormatTemperature()
+        {
+            ensureLoaded(keyFormat);
+            return formatTemperature;
+        }
+
+        /**
+         * Gets the 12-hour or 24-hour clock format
+         */
+        inline uint8_t getFormatHour()
+        {
+            ensureLoaded(keyFormat);
+            return formatHour;
+        }
+
         /**
          * Sets the daylight weekday number
+         * Every setter loads its key first, so the stored value does not replace the set one later.
          */
         inline void setDstWeekday(uint8_t dow)
         {
+            ensureLoaded(keyDst);
             dstRule.dow = dow;
         }
 
@@ -71,6 +156,7 @@ class ClockSettings
          */
         inline void setStdWeekday(uint8_t dow)
         {
+            ensureLoaded(keyStd);
             stdRule.dow = dow;
         }
 
@@ -79,6 +165,7 @@ class ClockSettings
          */
         inline void setDstMonth(uint8_t month)
         {
+            ensureLoaded(keyDst);
             dstRule.month = month;
         }
 
@@ -87,6 +174,7 @@ class ClockSettings
          */
         inline void setStdMonth(uint8_t month)
         {
+            ensureLoaded(keyStd);
             stdRule.month = month;
         }
 
@@ -95,6 +183,7 @@ class ClockSettings
          */
         inline void setDstWeek(uint8_t week)
         {
+            ensureLoaded(keyDst);
             dstRule.week = week;
         }
 
@@ -103,6 +192,7 @@ class ClockSettings
          */
         inline void setStdWeek(uint8_t week)
         {
+            ensureLoaded(keyStd);
             stdRule.week = week;
         }
 
@@ -111,6 +201,7 @@ class ClockSettings
          */
         inline void setDstHour(uint8_t hour)
         {
+            ensureLoaded(keyDst);
             dstRule.hour = hour;
         }
 
@@ -119,6 +210,7 @@ class ClockSettings
          */
         inline void setStdHour(uint8_t hour)
         {
+            ensureLoaded(keyStd);
             stdRule.hour = hour;
         }
 
@@ -127,6 +219,7 @@ class ClockSettings
          */
         inline void setDstOffset(int offset)
         {
+            ensureLoaded(keyDst);
             dstRule.offset = offset;
         }
 
@@ -135,6 +228,7 @@ class ClockSettings
          */
         inline void setStdOffset(int offset)
         {
+            ensureLoaded(keyStd);
             stdRule.offset = offset;
         }
 
@@ -143,6 +237,7 @@ class ClockSettings
          */
         inline void setHourlyAlarm(bool hourlyAlarm)
         {
+            ensureLoaded(keyAlarm);
             this->hourlyAlarm = hourlyAlarm;
         }
 
@@ -151,13 +246,112 @@ class ClockSettings
          */
         inline bool getHourlyAlarm()
         {
+            ensureLoaded(keyAlarm);
             return this->hourlyAlarm;
         }
 
 
     private:
-        //the settings ID to verify that the data is written correctly
-        uint32_t settingsId;
+        //the settings keys, each of them is loaded and saved separately
+        static const uint8_t keyDst = BIT(0);
+        static const uint8_t keyStd = BIT(1);
+        static const uint8_t keyAlarm = BIT(2);
+        static const uint8_t keyFormat = BIT(3);
+
+        /**
+         * The settings key and its part of the settings record
+         */
+        struct Key {
+            uint8_t id;
+            //the full settings name
+            const char *name;
+            //the offset of the value in ClockSettingsRecord
+            uint8_t offset;
+            //the value size
+            uint8_t size;
+        };
+
+        //the settings keys
+        static const Key keys[];
+
+        //the settings subtree of the clock
+        static const char settingsRoot[];
+
+        //the format versions of the settings record in the old whole-record log
+        static const uint8_t settingsVersion1 = 1;
+        static const uint8_t settingsVersion2 = 2;
+
+        //the settings ID of the version 1 record
+        static const uint32_t settingsIdV1 = 0x4322;
+
+        //the slot magic of the old whole-record log
+        static const uint16_t settingsLogMagic = 0x4322;
+
+        //the whole-record log written by the firmware before the settings subsystem
+        static ClockSettingsLog settingsLog;
+
+        //the settings object that receives the loaded values
+        static ClockSettings *instance;
+
+        //the settings subsystem handler of the clock subtree
+        static struct settings_handler settingsHandler;
+
+        //the keys that were loaded from the storage, it is read without the mutex
+        atomic_t loadedKeys = ATOMIC_INIT(0);
+
+        //the keys that are being loaded by the thread that holds the mutex
+        uint8_t loadingKeys = 0;
+
+        //the keys whose values in committedRecord match the storage
+        uint8_t committedKeys = 0;
+
+        //the values that were last read from or written to the storage
+        ClockSettingsRecord committedRecord;
+
+        //the old whole record is read only once for the migration
+        static const uint8_t legacyUnknown = 0;
+        static const uint8_t legacyAbsent = 1;
+        static const uint8_t legacyPresent = 2;
+        uint8_t legacyState = legacyUnknown;
+        ClockSettingsRecord legacyRecord;
+
+        //the mutex to limit simultaneous loads and saves
+        struct k_mutex mutexSettings;
+
+        /**
+         * Loads the key from the storage if it is not loaded yet
+         */
+        void ensureLoaded(uint8_t keyId);
+
+        /**
+         * Finds the key by its ID
+         */
+        static const Key *findKey(uint8_t keyId);
+
+        /**
+         * Applies the loaded value of the key if it is valid
+         */
+        int applyKeyValue(const Key *key, const void *value, size_t length);
+
+        /**
+         * Writes the value of the key from the record into the storage
+         */
+        int saveKey(const Key *key, const ClockSettingsRecord *record);
+
+        /**
+         * Takes the value of the key from the old whole record and saves it as the key
+         */
+        void migrateKey(const Key *key);
+
+        /**
+         * The settings subsystem handler that receives the loaded values
+         */
+        static int settingsSet(const char *name, size_t length, settings_read_cb readCb, void *cbArg);
+
+        /**
+         * Reads the old whole record from the record log or the address 0
+         */
+        int loadLegacyRecord(ClockSettingsRecord *record);
 
         //sets default values
         void setDefaultValues();
@@ -165,11 +359,39 @@ class ClockSettings
         //get the EEPROM device
         const struct device *getEepromDevice();
 
+        //loads the settings object written at the address 0 by the firmware without the log
+        int loadLegacy(const struct device *eeprom, ClockSettingsRecord *record);
+
+        //converts the version 1 record to the current one
+        bool migrateV1(const ClockSettingsRecordV1 *recordV1, ClockSettingsRecord *record);
+
+        //checks that all fields of the record are within their ranges
+        bool isValidRecord(const ClockSettingsRecord *record);
+
+        //copies the record into the variables of the class
+        void fromRecord(const ClockSettingsRecord *record);
+
+        //copies the variables of the class into the record
+        void toRecord(ClockSettingsRecord *record);
+
+        //converts the time change rule to the stored one and back
+        static void toRuleRecord(const TimeChangeRule *rule, ClockSettingsRuleRecord *ruleRecord);
+        static void fromRuleRecord(const ClockSettingsRuleRecord *ruleRecord, TimeChangeRule *rule);
+
         //read the temperature and 12-hour/24-hour format (Celsius/Fahrenheit 12/24 hour) setting pins 
         void readFormat();
 
-        //read one of the format setting pins
-        uint8_t readFormatPin(const struct gpio_dt_spec *gpio);
+        //the number of the format setting pins
+        static const uint8_t numberOfFormatPins = 3;
+
+        //the time for the format setting pins to settle after the enable-format pin is set, ms
+        static const uint8_t formatSettleTime = 10;
+
+        //configure one of the format setting pins as an input
+        void configureFormatPin(const struct gpio_dt_spec *gpio);
+
+        //read the levels of the format setting pins, one read for each GPIO port
+        void readFormatPins(const struct gpio_dt_spec *gpios, uint8_t *levels);
 };
 
 #endif
@@ -0,0 +1,130 @@
+/*
+ * The class for the append-only record log in the EEPROM
+ *
+ */
+#ifndef __CLOCK_SETTINGS_LOG_H
+#define __CLOCK_SETTINGS_LOG_H
+
+#include <zephyr/logging/log.h>
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/eeprom.h>
+#include <zephyr/sys/crc.h>
+
+#include <ClockMetrics.h>
+
+/**
+ * The header at the start of each slot
+ * It is written after the payload, so a torn write never produces a valid header
+ */
+struct ClockSettingsLogHeader {
+    //marks a written slot
+    uint16_t magic;
+    //the format version of the payload
+    uint8_t version;
+    //the payload length in bytes
+    uint8_t length;
+    //grows by one with every record
+    uint32_t sequence;
+} __attribute__((packed));
+
+/**
+ * The records are written one after another into fixed size slots and wrap around at the end of the region.
+ * Every save goes to the next slot, so the writes are spread over the whole region.
+ * The slot holds the header, the payload and the CRC16 of the header and the payload.
+ */
+class ClockSettingsLog
+{
+    public:
+        //the slot size in bytes, a multiple of the EEPROM page size
+        static const uint8_t slotSize = 64;
+
+        //the largest payload that fits into a slot with its header and CRC
+        static const uint8_t maxPayloadSize = slotSize - sizeof(ClockSettingsLogHeader) - sizeof(uint16_t);
+
+        /**
+         * The logs that share the EEPROM addresses must have different magics,
+         * so one of them never takes the records of the other one
+         */
+        constexpr ClockSettingsLog(const struct device *eeprom, uint32_t offset, uint32_t size, uint16_t magic)
+            : eeprom(eeprom), offset(offset), numberOfSlots(size / slotSize), magic(magic)
+        {
+        }
+
+        /**
+         * Reads the payload of the newest valid record
+         *
+         * @param uint8_t *version The format version of the payload
+         * @param void *payload The buffer for the payload
+         * @param uint8_t maxLength The buffer size
+         *
+         * @return int The payload length, -ENOENT if the log is empty or other negative error code
+         */
+        int read(uint8_t *version, void *payload, uint8_t maxLength);
+
+        /**
+         * Appends the record after the newest one
+         *
+         * @param uint8_t version The format version of the payload
+         * @param const void *payload The payload
+         * @param uint8_t length The payload length, not larger than maxPayloadSize
+         *
+         * @return int 0 on success or negative error code
+         */
+        int append(uint8_t version, const void *payload, uint8_t length);
+
+    private:
+        //how many older slots are tried if the newest record is broken
+        static const uint8_t maxFallbackSlots = 4;
+
+        //the EEPROM device
+        const struct device *eeprom;
+
+        //the start of the log region in the EEPROM
+        uint32_t offset;
+
+        //the number of slots in the region
+        uint32_t numberOfSlots;
+
+        //the value of the magic field in a written slot
+        uint16_t magic;
+
+        //the slot with the newest record, -1 if the log is empty
+        int32_t headSlot = -1;
+
+        //the sequence number of the newest record
+        uint32_t headSequence = 0;
+
+        //the head was found
+        bool scanned = false;
+
+        /**
+         * Finds the newest record with a binary search over the slot headers
+         */
+        int scan();
+
+        /**
+         * Reads the header of the slot
+         */
+        int readHeader(uint32_t slot, ClockSettingsLogHeader *header);
+
+        /**
+         * Checks if the slot was written after the slot 0 in the current pass over the region
+         */
+        bool isInCurrentPass(uint32_t slot, uint32_t firstSequence);
+
+        /**
+         * Calculates the CRC of the header and the payload
+         */
+        uint16_t calculateCrc(const ClockSettingsLogHeader *header, const void *payload);
+
+        /**
+         * Gets the EEPROM address of the slot
+         */
+        inline uint32_t getSlotAddress(uint32_t slot)
+        {
+            return offset + slot * slotSize;
+        }
+};
+
+#endif
@@ -0,0 +1,81 @@
+/*
+ * The settings subsystem storage backend in the AT24 EEPROM
+ *
+ */
+#ifndef __CLOCK_SETTINGS_STORAGE_H
+#define __CLOCK_SETTINGS_STORAGE_H
+
+#include <zephyr/logging/log.h>
+
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/settings/settings.h>
+
+#include <string.h>
+
+#include <ClockSettingsLog.h>
+
+/**
+ * The key with its own wear-leveled log region in the EEPROM
+ */
+struct ClockSettingsStorageKey {
+    //the full settings name, for example "clock/dst"
+    const char *name;
+    //the record log of the key values
+    ClockSettingsLog log;
+};
+
+/**
+ * Every key has its own region, so loading a key reads only its region
+ * and saving a key appends one record to its region only.
+ * Keys that are not in the table are not stored.
+ */
+class ClockSettingsStorage
+{
+    public:
+        /**
+         * Registers the storage as the source and the destination of the settings subsystem
+         */
+        static int init();
+
+    private:
+        //the format version of the value records
+        static const uint8_t valueVersion = 1;
+
+        //the slot magic of the key logs, the key regions overlap the old whole-record log
+        static const uint16_t keyLogMagic = 0x4b59;
+
+        //the stored keys
+        static ClockSettingsStorageKey keys[];
+
+        //the number of the stored keys
+        static const uint8_t numberOfKeys;
+
+        //the settings store registered in the settings subsystem
+        static struct settings_store store;
+
+        //the interface functions of the store
+        static const struct settings_store_itf storeInterface;
+
+        /**
+         * Finds the key by its full name
+         */
+        static ClockSettingsStorageKey *findKey(const char *name);
+
+        /**
+         * Loads the keys that match the subtree from the load arguments
+         */
+        static int load(struct settings_store *cs, const struct settings_load_arg *arg);
+
+        /**
+         * Saves the value of one key
+         */
+        static int save(struct settings_store *cs, const char *name, const char *value, size_t valueLength);
+
+        /**
+         * Copies the loaded value to the settings handler
+         */
+        static ssize_t readValue(void *cbArg, void *data, size_t length);
+};
+
+#endif
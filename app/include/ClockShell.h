@@ -0,0 +1,113 @@
+/*
+ * The class for the shell commands that configure the clock
+ *
+ */
+#ifndef __CLOCK_SHELL_H
+#define __CLOCK_SHELL_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/shell/shell.h>
+
+#include <stdlib.h>
+
+#include <ClockBootProfile.h>
+#include <ClockBrightness.h>
+#include <ClockDisplay.h>
+#include <ClockSettings.h>
+#include <ClockTime.h>
+#include <ClockTimezone.h>
+#include <ClockWatchdog.h>
+
+/**
+ * The "clock" shell command sets and gets the time, the time change rules, the hourly alarm,
+ * the correction offset and the brightness override, and prints the settings.
+ * Every command checks all its values first and then writes them with one RTC or one settings save,
+ * the same way as the buttons do. It does nothing if CONFIG_APP_SHELL is not set.
+ */
+class ClockShell
+{
+    public:
+        /**
+         * Sets the objects that the commands change, the commands fail until it is called
+         */
+        static void init(ClockSettings *clockSettings, ClockTime *clockTime, ClockDisplay *clockDisplay);
+
+        /**
+         * Prints the time or sets it: clock time [hh:mm[:ss] [yyyy-mm-dd]]
+         */
+        static int timeCommand(const struct shell *sh, size_t argc, char **argv);
+
+        /**
+         * Prints the daylight time start rule or sets it: clock dst [week weekday month hour offset]
+         */
+        static int dstCommand(const struct shell *sh, size_t argc, char **argv);
+
+        /**
+         * Prints the standard time start rule or sets it: clock std [week weekday month hour offset]
+         */
+        static int stdCommand(const struct shell *sh, size_t argc, char **argv);
+
+        /**
+         * Prints the hourly alarm or sets it: clock alarm [on|off]
+         */
+        static int alarmCommand(const struct shell *sh, size_t argc, char **argv);
+
+        /**
+         * Prints the RTC frequency correction offset or sets it: clock offset [-32..31]
+         */
+        static int offsetCommand(const struct shell *sh, size_t argc, char **argv);
+
+        /**
+         * Prints the brightness override or sets it: clock brightness [auto|0..15]
+         */
+        static int brightnessCommand(const struct shell *sh, size_t argc, char **argv);
+
+        /**
+         * Prints all the settings
+         */
+        static int settingsCommand(const struct shell *sh, size_t argc, char **argv);
+
+        /**
+         * Prints the watchdog report of the last reboot and the boot profile
+         */
+        static int diagCommand(const struct shell *sh, size_t argc, char **argv);
+
+    private:
+        //the objects that the commands change
+        static ClockSettings *clockSettings;
+        static ClockTime *clockTime;
+        static ClockDisplay *clockDisplay;
+
+        //the number of the values of a time change rule
+        static const uint8_t numberOfRuleValues = 5;
+
+        /**
+         * Checks that init() was called
+         */
+        static bool isReady(const struct shell *sh);
+
+        /**
+         * Parses the numbers divided by the separator, for example 12:30:00
+         *
+         * @return uint8_t The number of the parsed numbers or 0 if the string has other characters
+         */
+        static uint8_t parseNumbers(const char *str, char separator, long *numbers, uint8_t maxNumbers);
+
+        /**
+         * Parses one number and checks its range
+         */
+        static bool parseNumber(const struct shell *sh, const char *str, long minimum, long maximum, long *number);
+
+        /**
+         * Prints the time change rule
+         */
+        static void printRule(const struct shell *sh, const char *name, bool dst);
+
+        /**
+         * Checks and saves the time change rule from the command arguments
+         */
+        static int setRule(const struct shell *sh, char **argv, bool dst);
+};
+
+#endif
@@ -5,35 +5,68 @@
 #ifndef __CLOCK_TEMPERATURE_H
 #define __CLOCK_TEMPERATURE_H
 
-#include <zephyr/sys/printk.h>
+#include <zephyr/logging/log.h>
 
 #include <zephyr/device.h>
 #include <zephyr/devicetree.h>
 
 #include <zephyr/drivers/adc.h>
 #include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/sensor.h>
+
+#include <zephyr/sys/atomic.h>
+
+#include <stm32_ll_adc.h>
 
 #include <stdlib.h>
 
-struct ClockNtc {
-    //T [°C] 
-    int temperature;
-    //R nom [Ω]
-    float resistanceNom;
-    //R min [Ω]
-    float resistanceMin;
-    //R max [Ω] 
-    float resistanceMax;
-};
+#include <ClockMetrics.h>
+#include <ClockTemperatureHistory.h>
 
 class ClockTemperature
 {
     public:
         ClockTemperature();
 
-        //get the temperature in degrees Celcius
+        //the temperature when the ADC reading fails, degrees Celsius
+        const static int temperatureAdcError = -200;
+
+        //the displayed temperature when the NTC is open, shorted or out of the table range, degrees Celsius
+        const static int temperatureNotFound = -50;
+
+        //the NTC table value for the ADC codes out of the temperature range, it is below any table temperature
+        const static int16_t ntcInvalid = -32768;
+
+        //get the filtered temperature in degrees Celcius
         int getTemperature();
 
+        //get the filtered temperature in tenths of a degree Celsius
+        int getTemperatureDeci();
+
+        //read the temperature from the ADC now, in tenths of a degree Celsius, ntcInvalid if the NTC is out of range
+        int readTemperatureDeci();
+
+        //read the temperature of the RV-3032 RTC, in tenths of a degree Celsius
+        int readRtcTemperatureDeci();
+
+        //the temperature comes from the RTC because the thermistor is disconnected
+        inline bool isFallback()
+        {
+            return atomic_get(&usingFallback);
+        }
+
+        //get the temperature history of the trip
+        inline ClockTemperatureHistory *getHistory()
+        {
+            return &history;
+        }
+
+        //get the analog supply voltage measured with VREFINT during the last reading, mV
+        inline uint16_t getSupplyVoltage()
+        {
+            return supplyVoltage;
+        }
+
     private:
 
         //the ADC device
@@ -43,17 +76,101 @@ class ClockTemperature
 
         uint8_t channelId;
 
+        //the internal reference voltage channel, sampled in the same sequence
+        uint8_t vrefintChannelId;
+
+        //the number of the channels in the sequence
+        const static uint8_t numberOfChannels = 2;
+
+        //below this analog supply voltage the ADC is out of its specification, mV
+        const static uint16_t minSupplyVoltage = 1800;
+
+        //the analog supply voltage of the last reading, mV
+        uint16_t supplyVoltage = 0;
+
         //enable the pin before running the measurements
         struct gpio_dt_spec enablePin;
 
-        //the resistance to temperature lookup table for the NTC resistor
-        const static ClockNtc ntcLookupTable[108];
+        //the ADC resolution, the NTC table has an entry for every ADC code
+        const static uint8_t adcResolution = 12;
+
+#ifdef CONFIG_APP_TEMPERATURE_MULTI_SAMPLE
+        //the number of the conversions in one adc_read()
+        const static uint8_t numberOfSamples = CONFIG_APP_TEMPERATURE_SAMPLES;
+#else
+        const static uint8_t numberOfSamples = 1;
+#endif
+
+#ifdef CONFIG_APP_TEMPERATURE_OVERSAMPLING
+        //the hardware oversampling ratio as a power of 2
+        const static uint8_t oversampling = CONFIG_APP_TEMPERATURE_OVERSAMPLING_RATIO;
+#else
+        const static uint8_t oversampling = 0;
+#endif
+
+        //the ADC code to temperature table for the NTC resistor in tenths of a degree Celsius
+        //generated at build time by scripts/gen_ntc_table.py from the bmw,thermometer devicetree node
+        const static int16_t ntcAdcTable[];
+
+        /**
+         * Reduces the samples to one ADC code: the median or the mean without the smallest and the largest samples
+         *
+         * @param uint16_t *samples The samples, they are sorted in place
+         * @param uint8_t count The number of the samples
+         *
+         * @return uint16_t The ADC code
+         */
+        static uint16_t filterSamples(uint16_t *samples, uint8_t count);
+
+        //the period of the background sampling
+        const static uint16_t samplePeriod = CONFIG_APP_TEMPERATURE_SAMPLE_PERIOD;
+
+        //the weight of a new sample in the exponential filter is 1/2^filterShift
+        const static uint8_t filterShift = 2;
+
+        //the filtered temperature in 1/16 of a tenth of a degree Celsius
+        atomic_t filteredTemperature = ATOMIC_INIT(0);
+
+        //the filter has a valid sample
+        atomic_t filterReady = ATOMIC_INIT(0);
+
+        //the error of the last reading if there is no valid sample yet, tenths of a degree Celsius
+        atomic_t lastError = ATOMIC_INIT(temperatureAdcError * 10);
+
+        //the number of the failed readings in a row before the error is shown
+        const static uint8_t maxErrors = 3;
+
+        //the temperature sensor of the RTC, NULL if it is not in the devicetree
+        const struct device *rtcTemperature;
+
+        //the RTC temperature is used instead of the thermistor
+        atomic_t usingFallback = ATOMIC_INIT(0);
+
+        //the failed readings in a row
+        atomic_t errorCount = ATOMIC_INIT(0);
+
+        //the number of the background samples between the history samples
+        const static uint16_t historyInterval = (CONFIG_APP_TEMPERATURE_HISTORY_PERIOD * 60 > samplePeriod)
+            ? (CONFIG_APP_TEMPERATURE_HISTORY_PERIOD * 60 / samplePeriod) : 1;
+
+        //the background samples since the last history sample
+        uint16_t historyTicks = 0;
+
+        //the downsampled temperatures of the trip
+        ClockTemperatureHistory history;
+
+        //the background sampling work
+        struct k_work_delayable sampleWork;
 
-        //the analog reference voltage for ADC
-        const static uint16_t adcVref = 3300;
+        /**
+         * Reads the temperature and adds it to the filter
+         */
+        void sample();
 
-        //the resistor divider top part resistor value in Ohm
-        const static uint16_t dividerResistor = 4700;
+        /**
+         * The background sampling work handler, reschedules itself
+         */
+        static void sampleWorkHandler(struct k_work *work);
 
         //the mutex to limit simultaneous access to the ADC hardware
         struct k_mutex mutexAdc;
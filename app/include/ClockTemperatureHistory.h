@@ -0,0 +1,128 @@
+/*
+ * The class for the temperature history of the trip
+ * 
+ */
+#ifndef __CLOCK_TEMPERATURE_HISTORY_H
+#define __CLOCK_TEMPERATURE_HISTORY_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/hwinfo.h>
+
+#include <driver_rtc.h>
+
+#include <ClockMetrics.h>
+
+/**
+ * Keeps the downsampled temperatures in a ring buffer of half degrees.
+ * The minimum and the maximum are updated with every new sample, so they are never rescanned.
+ * The trend is the difference between the newest sample and the sample about an hour older.
+ * With CONFIG_APP_TEMPERATURE_HISTORY_RTC_RAM the newest samples, the minimum and the maximum
+ * are also kept in the RV-3032 user RAM, so they survive a reset. A power-up starts a new trip.
+ */
+class ClockTemperatureHistory
+{
+    public:
+        ClockTemperatureHistory();
+
+        /**
+         * Adds the sample to the history
+         *
+         * @param int temperature The temperature in tenths of a degree Celsius
+         */
+        void add(int temperature);
+
+        /**
+         * Checks if the history has any samples
+         */
+        bool isEmpty();
+
+        /**
+         * Gets the lowest temperature of the trip in tenths of a degree Celsius
+         */
+        int getMinimum();
+
+        /**
+         * Gets the highest temperature of the trip in tenths of a degree Celsius
+         */
+        int getMaximum();
+
+        /**
+         * Gets the temperature change over the trend window in tenths of a degree Celsius
+         */
+        int getTrend();
+
+    private:
+        //the number of the samples in the ring buffer
+        static const uint8_t size = 96;
+
+        //the trend window in samples, about an hour
+        static const uint8_t trendSamples = (60 / CONFIG_APP_TEMPERATURE_HISTORY_PERIOD > 0)
+            ? (60 / CONFIG_APP_TEMPERATURE_HISTORY_PERIOD) : 1;
+
+        //the RV-3032 user RAM layout: the magic, the minimum, the maximum, the count, the head and the samples
+        static const uint8_t ramStart = 0x40;
+        static const uint8_t ramMagic = ramStart;
+        static const uint8_t ramMinimum = ramStart + 1;
+        static const uint8_t ramMaximum = ramStart + 2;
+        static const uint8_t ramCount = ramStart + 3;
+        static const uint8_t ramHead = ramStart + 4;
+        static const uint8_t ramSamples = ramStart + 5;
+        static const uint8_t ramSize = 0x50 - ramSamples;
+
+        //marks the valid history in the RTC RAM
+        static const uint8_t ramMagicValue = 0xe3;
+
+        //the samples in half degrees Celsius
+        int8_t samples[size];
+
+        //the position for the next sample
+        uint8_t head = 0;
+
+        //the number of the samples in the ring buffer
+        uint8_t count = 0;
+
+        //the lowest and the highest sample of the trip in half degrees Celsius
+        int8_t minimum = INT8_MAX;
+        int8_t maximum = INT8_MIN;
+
+        //the position for the next sample in the RTC RAM ring
+        uint8_t ramPosition = 0;
+
+        //the number of the samples in the RTC RAM ring
+        uint8_t ramSampleCount = 0;
+
+        //the history was restored from the RTC RAM
+        bool restored = false;
+
+        //the RTC device with the user RAM
+        const struct device *rtc;
+
+        //the mutex to limit simultaneous access to the history
+        struct k_mutex mutexHistory;
+
+        /**
+         * Stores the sample in the ring buffer and updates the minimum and the maximum
+         */
+        void push(int8_t sample);
+
+        /**
+         * Reads the history saved in the RTC RAM before the reset
+         */
+        void restore();
+
+        /**
+         * Writes the sample, the minimum and the maximum to the RTC RAM
+         */
+        void persist(int8_t sample, bool minimumChanged, bool maximumChanged);
+
+        /**
+         * Converts tenths of a degree to half degrees
+         */
+        static int8_t toHalfDegrees(int temperature);
+};
+
+#endif
@@ -0,0 +1,119 @@
+/*
+ * The class for the runtime and the stack statistics of the threads
+ *
+ */
+#ifndef __CLOCK_THREAD_STATS_H
+#define __CLOCK_THREAD_STATS_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * The statistics of one thread from the last sample
+ */
+struct ClockThreadStatsEntry {
+    //the sampled thread
+    const struct k_thread *thread;
+    //the thread name
+    char name[16];
+    //the stack size in bytes
+    uint32_t stackSize;
+    //the largest stack use since the thread started in bytes
+    uint32_t stackUsed;
+    //the execution cycles at the last sample
+    uint64_t cycles;
+    //the CPU load between the last two samples in tenths of a percent
+    uint16_t load;
+    //the stack use warning was logged
+    bool warned;
+};
+
+/**
+ * The threads are sampled periodically on the system work queue.
+ * The stack use is the high-water mark found in the stack that was filled at the thread start,
+ * the load is the share of the execution cycles of the thread between the samples.
+ * A stack that uses less than a half is a candidate to shrink, a stack that uses more than 80% is a risk.
+ * CONFIG_APP_STACK_REPORT prints the static stack use with the same marks after the build.
+ * It does nothing if CONFIG_APP_THREAD_STATS is not set.
+ */
+class ClockThreadStats
+{
+    public:
+        //the stack use below this percent is a candidate to shrink
+        static const uint8_t stackShrinkPercent = 50;
+
+        //the stack use above this percent is a risk
+        static const uint8_t stackRiskPercent = 80;
+
+        /**
+         * Starts the periodic sampling
+         */
+        static void init();
+
+        /**
+         * Samples all the threads now
+         */
+        static void sample();
+
+        /**
+         * Gets the number of the sampled threads
+         */
+        static uint8_t getNumberOfThreads();
+
+        /**
+         * Gets a copy of the statistics of the sampled thread
+         *
+         * @param uint8_t number The thread number in the last sample
+         */
+        static ClockThreadStatsEntry getThread(uint8_t number);
+
+        /**
+         * Gets the stack use in percent
+         */
+        static inline uint8_t getStackPercent(const ClockThreadStatsEntry *entry)
+        {
+            return (entry->stackSize > 0) ? (entry->stackUsed * 100 / entry->stackSize) : 0;
+        }
+
+    private:
+        //the largest number of the sampled threads
+        static const uint8_t maxThreads = 16;
+
+        //the statistics of the threads
+        static ClockThreadStatsEntry threads[maxThreads];
+
+        //the number of the sampled threads
+        static uint8_t numberOfThreads;
+
+        //the execution cycles of all the threads at the last sample
+        static uint64_t totalCycles;
+
+        //the execution cycles of all the threads between the last two samples
+        static uint64_t periodCycles;
+
+        //the periodic sampling work
+        static struct k_work_delayable sampleWork;
+
+        //the mutex to limit simultaneous samples and reads
+        static struct k_mutex mutexStats;
+
+        /**
+         * Adds the thread to the sample, it is called for every thread
+         */
+        static void sampleThread(const struct k_thread *thread, void *userData);
+
+        /**
+         * Finds the statistics of the thread or adds them
+         */
+        static ClockThreadStatsEntry *findThread(const struct k_thread *thread);
+
+        /**
+         * The sampling work handler, reschedules itself
+         */
+        static void sampleWorkHandler(struct k_work *work);
+};
+
+#endif
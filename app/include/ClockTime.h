@@ -9,8 +9,10 @@
 #include <driver_rtc.h>
 #include <stm32_ll_rtc.h>
 
-#include <zephyr/sys/printk.h>
+#include <zephyr/logging/log.h>
 
+#include <ClockEventLoop.h>
+#include <ClockMetrics.h>
 #include <ClockSettings.h>
 #include <ClockTimeLib.h>
 #include <ClockTimezone.h>
@@ -169,11 +171,13 @@ class ClockTime
          */
         inline bool isStartDstWithinOneHourLocal(int64_t currentTime)
         {
-            printk("isStartDstWithinOneHour %lld\n", currentTime);
+            LOG_MODULE_DECLARE(clock_time, CONFIG_APP_TIME_LOG_LEVEL);
 
-            printk("timezone.getStartDst: %lld\n", timezone.getStartDst());
+            LOG_DBG("isStartDstWithinOneHour %lld", currentTime);
 
-            printk("timezone.getStartDst + 1 hour: %lld\n", timezone.getStartDst() + 1 * 60 * 60);
+            LOG_DBG("timezone.getStartDst: %lld", timezone.getStartDst());
+
+            LOG_DBG("timezone.getStartDst + 1 hour: %lld", timezone.getStartDst() + 1 * 60 * 60);
 
             return (((currentTime >= timezone.getStartDst()) && (currentTime <= (timezone.getStartDst() + 1 * 60 * 60))) ? true : false);
         }
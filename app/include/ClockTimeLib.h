@@ -6,7 +6,7 @@
 #define __CLOCK_TIMELIB_H
 
 #include <time.h>
-#include <zephyr/sys/printk.h>
+#include <zephyr/logging/log.h>
 
 
 class ClockTimeLib 
@@ -7,7 +7,7 @@
 
 #include <time.h>
 
-#include <zephyr/sys/printk.h>
+#include <zephyr/logging/log.h>
 #include <ClockTimeLib.h>
 
 // Constants for TimeChangeRules
@@ -41,6 +41,14 @@ class ClockTimezone
 
         void setRules(TimeChangeRule *dstRule, TimeChangeRule *stdRule, uint32_t year);
 
+        /**
+         * Recalculates the time changes of the current year after the rules were changed
+         */
+        inline void updateRules()
+        {
+            calculateTimeChange();
+        }
+
         /**
          * Converts the UTC UNIX time to the local time
          */
@@ -283,11 +291,13 @@ class ClockTimezone
          */
         inline const uint8_t getOffsetNumber(int offset)
         {
-            printk("numberofoffsets: %d\n", getNumberOfOffsets());
+            LOG_MODULE_DECLARE(clock_timezone, CONFIG_APP_TIME_LOG_LEVEL);
+
+            LOG_DBG("numberofoffsets: %d", getNumberOfOffsets());
 
             for (uint8_t i = 0; i < getNumberOfOffsets(); i++) {
                 if (offsets[i] == offset) {
-                    printk("offsets[i]: %d\n", offsets[i]);
+                    LOG_DBG("offsets[i]: %d", offsets[i]);
                     return i;
                 }
             }
@@ -295,6 +305,20 @@ class ClockTimezone
             return 0;
         }
 
+        /**
+         * Checks if the offset is in the array of the offsets
+         */
+        inline const bool isOffset(int offset)
+        {
+            for (uint8_t i = 0; i < getNumberOfOffsets(); i++) {
+                if (offsets[i] == offset) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
         /**
          * Gets the offset by its number in the array
          */
@@ -5,27 +5,91 @@
 #ifndef __CLOCK_WATCHDOG_H
 #define __CLOCK_WATCHDOG_H
 
-#include <zephyr/sys/printk.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/reboot.h>
 
 #include <zephyr/device.h>
 #include <zephyr/devicetree.h>
 #include <zephyr/drivers/watchdog.h>
+#include <zephyr/task_wdt/task_wdt.h>
 
+#include <string.h>
+
+/**
+ * The report of the thread that missed its deadline, it survives the reboot in the no init RAM
+ */
+struct ClockWatchdogReport {
+    //marks the valid report
+    uint32_t magic;
+    //the name of the thread
+    char name[16];
+    //the uptime of the miss in ms
+    uint32_t uptime;
+};
+
+/**
+ * Every long-lived thread has its own task watchdog channel with its own deadline.
+ * The task watchdog feeds the hardware IWDG from its timer only while all the channels are fed in time.
+ * If a channel misses its deadline, the thread name is stored for the next boot and the clock reboots.
+ */
 class ClockWatchdog
 {
     public:
-        ClockWatchdog();
+        /**
+         * Registers the channel of the current thread
+         *
+         * @param const char *name The thread name for the report
+         * @param uint32_t deadline The longest time between the feeds in ms
+         */
+        ClockWatchdog(const char *name, uint32_t deadline);
 
         void feed();
 
+        /**
+         * Gets the timeout for the blocking waits, so the thread wakes up and feeds the channel in time
+         */
+        k_timeout_t getWaitTimeout();
+
+        /**
+         * Starts the task watchdog with the hardware IWDG and prints the report of the previous boot
+         * It must be called before any thread registers its channel.
+         */
+        static int init();
+
+        /**
+         * Gets the name of the thread that missed its deadline before the last reboot
+         *
+         * @return const char* The thread name or NULL if there was no miss
+         */
+        static const char *getLastMissed();
+
     private:
-        const struct device *watchdog;
+        //the magic of the valid report
+        static const uint32_t reportMagic = 0x57444f47;
+
+        //the task watchdog started
+        static bool initialized;
+
+        //the report of the missed deadline
+        static ClockWatchdogReport report;
 
+        //the name of the thread that missed its deadline before the reboot
+        static char lastMissed[sizeof(report.name)];
+
+        //the task watchdog channel
         int watchdogChannelId;
 
-        int init();
+        //the thread name
+        const char *name;
+
+        //the deadline in ms
+        uint32_t deadline;
 
+        /**
+         * Stores the report and reboots, it is called from the task watchdog timer
+         */
+        static void missed(int channelId, void *userData);
 };
 
 #endif
-
@@ -18,6 +18,15 @@
 extern "C" {
 #endif
 
+/**
+ * @brief Called by the RTC drivers on I2C before every I2C transaction.
+ *
+ * The default is empty, the application may replace it to count the transactions.
+ *
+ * @param dev Pointer to the device structure for the driver instance.
+ */
+void rtc_i2c_transaction(const struct device *dev);
+
 /** @brief Alarm callback
  *
  * @param dev       Pointer to the device structure for the driver instance.
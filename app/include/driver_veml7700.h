@@ -0,0 +1,46 @@
+/**
+ * @file
+ * @brief VEML7700 private sensor attributes.
+ */
+
+/*
+ * Copyright (c) 2022 Farit N
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef APP_INCLUDE_DRIVERS_VEML7700_H_
+#define APP_INCLUDE_DRIVERS_VEML7700_H_
+
+#include <zephyr/drivers/sensor.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum sensor_attribute_veml7700 {
+    /**
+     * Power saving mode of the SENSOR_CHAN_LIGHT channel.
+     * val1 is 0 to disable it or 1-4 for the modes 1-4,
+     * the sensor waits 500, 1000, 2000 or 4000 ms between the measurements.
+     */
+    SENSOR_ATTR_VEML7700_PSM = SENSOR_ATTR_PRIV_START,
+};
+
+/** The number of the power saving modes */
+#define VEML7700_PSM_MODES 4
+
+/**
+ * @brief Called by the driver before every I2C transaction.
+ *
+ * The default is empty, the application may replace it to count the transactions.
+ *
+ * @param dev Pointer to the device structure for the driver instance.
+ */
+void veml7700_i2c_transaction(const struct device *dev);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
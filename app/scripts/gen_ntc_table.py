@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2022 Farit N
+# SPDX-License-Identifier: Apache-2.0
+#
+# Generates the ADC code to temperature table for the NTC thermistor.
+# The NTC is the bottom part of the resistor divider, so the code is ratiometric:
+# R = divider * code / (full scale - code).
+# The table holds the temperature in tenths of a degree Celsius for every ADC code,
+# the codes outside of the valid range hold the invalid value.
+
+import argparse
+import math
+import sys
+
+KELVIN = 273.15
+
+#the temperature range of the table, degrees Celsius
+MIN_TEMPERATURE = -55.0
+MAX_TEMPERATURE = 150.0
+
+#must match ClockTemperature::ntcInvalid
+INVALID = -32768
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--r25", type=float, required=True,
+                        help="NTC resistance at 25 degrees Celsius, Ohm")
+    parser.add_argument("--beta", type=float, required=True,
+                        help="NTC Beta coefficient, K")
+    parser.add_argument("--steinhart-hart", nargs=3, type=float, metavar=("A", "B", "C"),
+                        help="Steinhart-Hart coefficients, used instead of Beta")
+    parser.add_argument("--divider", type=float, required=True,
+                        help="the divider top resistor, Ohm")
+    parser.add_argument("--resolution", type=int, default=12,
+                        help="ADC resolution, bits")
+    parser.add_argument("--output", required=True,
+                        help="the output file")
+    return parser.parse_args()
+
+
+def temperature(resistance, args):
+    if args.steinhart_hart:
+        a, b, c = args.steinhart_hart
+        log = math.log(resistance)
+        kelvin = 1.0 / (a + b * log + c * log ** 3)
+    else:
+        kelvin = 1.0 / (1.0 / (25.0 + KELVIN) + math.log(resistance / args.r25) / args.beta)
+
+    return kelvin - KELVIN
+
+
+def main():
+    args = parse_args()
+    full_scale = 1 << args.resolution
+    table = []
+
+    for code in range(full_scale):
+        value = INVALID
+
+        #the NTC is shorted or open
+        if 0 < code < full_scale - 1:
+            celsius = temperature(args.divider * code / (full_scale - code), args)
+            if MIN_TEMPERATURE <= celsius <= MAX_TEMPERATURE:
+                value = int(round(celsius * 10))
+
+        table.append(value)
+
+    with open(args.output, "w") as output:
+        output.write("/* Generated by gen_ntc_table.py, do not edit */\n")
+        for i in range(0, full_scale, 16):
+            output.write("    " + ", ".join("%d" % v for v in table[i:i + 16]) + ",\n")
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
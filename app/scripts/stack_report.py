@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2022 Farit N
+# SPDX-License-Identifier: Apache-2.0
+#
+# Prints the static stack use of the thread entries next to their configured stack sizes.
+# The compiler writes the call graph with the stack use of every function (-fcallgraph-info=su),
+# the stack use of a thread is the largest sum along the calls from its entry function.
+# The indirect calls, the recursion and the functions without the call graph are not followed,
+# the use of such a thread is a lower bound.
+# The stack sizes are the sizes of the stack symbols in the ELF file,
+# a stack inside the driver data has no symbol, so its size is given instead.
+
+import argparse
+import os
+import re
+import sys
+
+from elftools.elf.elffile import ELFFile
+from elftools.elf.sections import SymbolTableSection
+
+#must match ClockThreadStats::stackShrinkPercent and ClockThreadStats::stackRiskPercent
+SHRINK_PERCENT = 50
+RISK_PERCENT = 80
+
+INDIRECT_CALL = "__indirect_call"
+
+NODE_RE = re.compile(r'node:\s*\{\s*title:\s*"([^"]*)"\s*label:\s*"([^"]*)"')
+EDGE_RE = re.compile(r'edge:\s*\{\s*sourcename:\s*"([^"]*)"\s*targetname:\s*"([^"]*)"')
+BYTES_RE = re.compile(r'(\d+) bytes \((static|dynamic|dynamic,bounded)\)')
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--build-dir", required=True,
+                        help="the build directory with the .ci call graph files")
+    parser.add_argument("--elf", required=True,
+                        help="the linked ELF file")
+    parser.add_argument("--thread", nargs="+", required=True, metavar="NAME:ENTRY:STACK",
+                        help="the thread name, its entry function and its stack symbol or size in bytes, "
+                             "the entry may be empty to report only the stack size")
+    return parser.parse_args()
+
+
+def function_name(label):
+    #the first line of the label is the declaration, the name is before the arguments
+    declaration = label.split("\\n")[0]
+    return declaration.split("(")[0].split(" ")[-1]
+
+
+def read_call_graph(build_dir):
+    functions = {}
+    calls = {}
+    names = {}
+
+    for root, _, files in os.walk(build_dir):
+        for file in files:
+            if not file.endswith(".ci"):
+                continue
+
+            with open(os.path.join(root, file), encoding="utf-8", errors="replace") as ci:
+                text = ci.read()
+
+            for title, label in NODE_RE.findall(text):
+                match = BYTES_RE.search(label)
+
+                #a declaration without the stack use does not replace the definition
+                if match or (title not in functions):
+                    functions[title] = int(match.group(1)) if match else None
+
+                names.setdefault(function_name(label), set()).add(title)
+
+            for source, target in EDGE_RE.findall(text):
+                calls.setdefault(source, set()).add(target)
+
+    return functions, calls, names
+
+
+def stack_use(title, functions, calls, memo, visiting):
+    """Gets the largest stack use from the function and if it is only a lower bound"""
+    if title in memo:
+        return memo[title]
+
+    if (title == INDIRECT_CALL) or (title in visiting):
+        return 0, True
+
+    own = functions.get(title)
+    if own is None:
+        return 0, True
+
+    visiting.add(title)
+
+    deepest = 0
+    lower_bound = False
+
+    for callee in calls.get(title, ()):
+        use, bound = stack_use(callee, functions, calls, memo, visiting)
+        deepest = max(deepest, use)
+        lower_bound = lower_bound or bound
+
+    visiting.discard(title)
+
+    memo[title] = (own + deepest, lower_bound)
+
+    return memo[title]
+
+
+def read_stack_sizes(elf_path):
+    sizes = {}
+
+    with open(elf_path, "rb") as file:
+        elf = ELFFile(file)
+
+        for section in elf.iter_sections():
+            if not isinstance(section, SymbolTableSection):
+                continue
+
+            for symbol in section.iter_symbols():
+                if symbol["st_info"]["type"] == "STT_OBJECT":
+                    sizes[symbol.name] = symbol["st_size"]
+
+    return sizes
+
+
+def main():
+    args = parse_args()
+    functions, calls, names = read_call_graph(args.build_dir)
+    sizes = read_stack_sizes(args.elf)
+    memo = {}
+
+    print("%-12s %-24s %6s %6s %4s" % ("thread", "entry", "stack", "static", "%"))
+
+    for thread in args.thread:
+        name, entry, symbol = thread.split(":")
+
+        if symbol.isdigit():
+            size = int(symbol)
+        elif symbol in sizes:
+            size = sizes[symbol]
+        else:
+            #the thread is not built in this configuration
+            continue
+
+        if not entry:
+            print("%-12s %-24s %6u %6s" % (name, "-", size, "-"))
+            continue
+
+        titles = [title for title in names.get(entry, {entry}) if functions.get(title) is not None]
+        if not titles:
+            print("%-12s %-24s %6u %6s no call graph" % (name, entry, size, "-"))
+            continue
+
+        use, lower_bound = max(stack_use(title, functions, calls, memo, set()) for title in titles)
+        percent = use * 100 // size if size else 0
+
+        flags = []
+        if percent > RISK_PERCENT:
+            flags.append("risk")
+        elif percent < SHRINK_PERCENT:
+            flags.append("shrink")
+        if lower_bound:
+            flags.append("lower bound")
+
+        static = (">=" if lower_bound else "") + str(use)
+
+        print("%-12s %-24s %6u %6s %3u%% %s" % (name, entry, size, static, percent, ", ".join(flags)))
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,31 +1,47 @@
 #include <ClockAlarm.h>
 
+LOG_MODULE_REGISTER(clock_alarm, CONFIG_APP_TIME_LOG_LEVEL);
+
 ClockAlarm::ClockAlarm(ClockSettings *clockSettings, ClockTime *clockTime)
 {
-    printk("Init ClockAlarm.\n");
+    LOG_DBG("Init ClockAlarm");
 
     this->clockSettings = clockSettings;
     this->clockTime = clockTime;
 }
 
-void ClockAlarm::process()
+void ClockAlarm::process(ClockWatchdog *watchdog)
 {
-    printk("Process ClockAlarm thread.\n");
+    LOG_DBG("Process ClockAlarm thread");
 
     while (1) {
-        k_sem_take(&clockTime->alarmSemaphore, K_FOREVER);
+        watchdog->feed();
+
+        //wakes up without an alarm to feed the watchdog
+        int ret = k_sem_take(&clockTime->alarmSemaphore, watchdog->getWaitTimeout());
 
-        printk("Processing in ClockAlarm thread\n");
+        ClockMetrics::countWakeup();
 
-        if (clockSettings->getHourlyAlarm()) {
-            //plays the gong sound named T1
-            ClockGong clockGong;
-            clockGong.playT1();
+        if (ret != 0) {
+            continue;
         }
 
+        processAlarm();
+
         k_sem_reset(&clockTime->alarmSemaphore);
+    }
+
+}
+
+void ClockAlarm::processAlarm()
+{
+    LOG_DBG("Processing in ClockAlarm");
 
-        printk("End processing in ClockAlarm\n");
+    if (clockSettings->getHourlyAlarm()) {
+        //plays the gong sound named T1
+        ClockGong clockGong;
+        clockGong.playT1();
     }
 
+    LOG_DBG("End processing in ClockAlarm");
 }
\ No newline at end of file
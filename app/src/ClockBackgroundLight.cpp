@@ -1,5 +1,7 @@
 #include <ClockBackgroundLight.h>
 
+LOG_MODULE_REGISTER(clock_background_light, CONFIG_APP_DISPLAY_LOG_LEVEL);
+
 gpio_callback ClockBackgroundLight::callbackData;
 
 struct k_sem ClockBackgroundLight::interruptSemaphore;
@@ -11,7 +13,7 @@ ClockBackgroundLight::ClockBackgroundLight(ClockDisplay *clockDisplay)
     this->clockDisplay = clockDisplay;
 
     if (clockDisplay->display == NULL) {
-        printk("Device HT1632C not found in Background Light info.\n");
+        LOG_ERR("Device HT1632C not found in Background Light info");
         return;
     }
 
@@ -32,13 +34,13 @@ ClockBackgroundLight::ClockBackgroundLight(ClockDisplay *clockDisplay)
 
 void ClockBackgroundLight::render()
 {
-    printk("backgroundLightInterruptCalled was On\n");
+    LOG_DBG("backgroundLightInterruptCalled was On");
 
     const struct gpio_dt_spec lightSensor = getSensor();
 
     int level = gpio_pin_get_dt(&lightSensor);
 
-    printk("Background Light Input Level: %d\n", level);
+    LOG_DBG("Background Light Input Level: %d", level);
 
     lightOn = (level ? true : false);
 
@@ -50,9 +52,13 @@ void ClockBackgroundLight::render()
         //send the rows 30 and 31 starting from the 3CH address
         display_write(clockDisplay->display, 0x3c, 0, &bufDesc, bufDisplay);
 
+        ClockMetrics::count(ClockMetrics::counterDisplayWrites);
+        ClockMetrics::count(ClockMetrics::counterDisplayBytes, bufDesc.buf_size);
+
         k_mutex_unlock(&clockDisplay->mutexDisplay);
     } else {
-        printk("Display Mutex timeout\n");
+        ClockMetrics::count(ClockMetrics::counterMutexTimeouts);
+        LOG_WRN("Display Mutex timeout");
     }
 
 }
@@ -91,21 +97,21 @@ int ClockBackgroundLight::initInterrupt()
     const struct gpio_dt_spec gpio = getSensor();
 
     if (!device_is_ready(gpio.port)) {
-        printk("Error: GPIO light device %s is not ready\n", gpio.port->name);
+        LOG_ERR("Error: GPIO light device %s is not ready", gpio.port->name);
         return 1;
     }
 
     //active when the level is low
     int ret = gpio_pin_configure_dt(&gpio, GPIO_INPUT | GPIO_ACTIVE_LOW | GPIO_PULL_UP);
     if (ret != 0) {
-        printk("Error %d: failed to configure %s pin %d\n",
+        LOG_ERR("Error %d: failed to configure %s pin %d",
            ret, gpio.port->name, gpio.pin);
         return 1;
     }
 
     ret = gpio_pin_interrupt_configure_dt(&gpio, GPIO_INT_EDGE_BOTH);
     if (ret != 0) {
-        printk("Error %d: failed to configure interrupt on %s pin %d\n",
+        LOG_ERR("Error %d: failed to configure interrupt on %s pin %d",
             ret, gpio.port->name, gpio.pin);
         return 1;
     }
@@ -113,13 +119,13 @@ int ClockBackgroundLight::initInterrupt()
     gpio_init_callback(&callbackData, changed, BIT(gpio.pin));
     gpio_add_callback(gpio.port, &callbackData);
 
-    printk("Set up background light GPIO at %s pin %d\n", gpio.port->name, gpio.pin);
+    LOG_DBG("Set up background light GPIO at %s pin %d", gpio.port->name, gpio.pin);
 
     uint8_t levelRaw = gpio_pin_get_raw(gpio.port, gpio.pin);
-    printk("\nLevelRaw: %u\n", levelRaw);
+    LOG_DBG("LevelRaw: %u", levelRaw);
 
     int level = gpio_pin_get_dt(&gpio);
-    printk("\nLevel: %d\n", level);
+    LOG_DBG("Level: %d", level);
 
     //check the background light sensor level the first time
     render();
@@ -129,27 +135,44 @@ int ClockBackgroundLight::initInterrupt()
 
 void ClockBackgroundLight::changed(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
 {
-    printk("Background light GPIO interrupt: %s, pins: %zu\n", dev->name, pins);
+    LOG_DBG("Background light GPIO interrupt: %s, pins: %zu", dev->name, pins);
 
-    //send the semaphore signal to the ClockBackgroundLight thread
-    k_sem_give(&interruptSemaphore);
+    //send the semaphore signal to the ClockBackgroundLight thread or the event loop
+    if (IS_ENABLED(CONFIG_APP_EVENT_LOOP)) {
+        ClockEventLoop::post(ClockEventLoop::eventBackgroundLight);
+    } else {
+        k_sem_give(&interruptSemaphore);
+    }
 }
 
-void ClockBackgroundLight::process()
+void ClockBackgroundLight::process(ClockWatchdog *watchdog)
 {
-    printk("Process the ClockBackgroundLight thread.\n");
+    LOG_DBG("Process the ClockBackgroundLight thread");
 
     while (1) {
-        k_sem_take(&interruptSemaphore, K_FOREVER);
+        watchdog->feed();
 
-        printk("Processing in ClockBackgroundLight thread\n");
+        //wakes up without an interrupt to feed the watchdog
+        int ret = k_sem_take(&interruptSemaphore, watchdog->getWaitTimeout());
 
-        render();
+        ClockMetrics::countWakeup();
 
-        k_sem_reset(&interruptSemaphore);
+        if (ret != 0) {
+            continue;
+        }
 
-        printk("End processing in ClockbackgroundLight\n");
+        processChange();
 
+        k_sem_reset(&interruptSemaphore);
     }
 
+}
+
+void ClockBackgroundLight::processChange()
+{
+    LOG_DBG("Processing in ClockBackgroundLight");
+
+    render();
+
+    LOG_DBG("End processing in ClockbackgroundLight");
 }
\ No newline at end of file
@@ -0,0 +1,35 @@
+#include <ClockBootProfile.h>
+
+LOG_MODULE_REGISTER(clock_boot_profile, CONFIG_APP_LOG_LEVEL);
+
+const char *const ClockBootProfile::stageNames[] = {"main", "settings", "time", "temperature",
+    "display", "first frame", "threads"};
+
+uint32_t ClockBootProfile::stamps[ClockBootProfile::numberOfStages];
+
+uint32_t ClockBootProfile::markedStages = 0;
+
+void ClockBootProfile::dump()
+{
+    uint32_t previous = 0;
+
+    if (!IS_ENABLED(CONFIG_APP_BOOT_PROFILE)) {
+        LOG_WRN("The boot profile is disabled");
+        return;
+    }
+
+    LOG_INF("Boot profile, %u cycles/s:", sys_clock_hw_cycles_per_sec());
+
+    for (uint8_t i = 0; i < numberOfStages; i++) {
+        if (!(markedStages & BIT(i))) {
+            LOG_INF("  %-12s not reached", stageNames[i]);
+            continue;
+        }
+
+        //the cycle difference is correct across a counter wrap
+        LOG_INF("  %-12s at %u us, took %u us", stageNames[i],
+            k_cyc_to_us_floor32(stamps[i]), k_cyc_to_us_floor32(stamps[i] - previous));
+
+        previous = stamps[i];
+    }
+}
@@ -0,0 +1,88 @@
+#include <ClockBrightness.h>
+
+LOG_MODULE_REGISTER(clock_brightness, CONFIG_APP_SENSORS_LOG_LEVEL);
+
+/**
+ * The map from the logarithmic index to the display level
+ */
+struct ClockBrightnessMap {
+    uint8_t levels[ClockBrightness::numberOfIndexes];
+
+    constexpr ClockBrightnessMap() : levels()
+    {
+        //the levels are spread evenly over the indexes between the dark and the bright light
+        constexpr uint8_t darkIndex = ClockBrightness::getIndex(CONFIG_APP_BRIGHTNESS_DARK_MILLILUX);
+        constexpr uint8_t brightIndex = ClockBrightness::getIndex(CONFIG_APP_BRIGHTNESS_BRIGHT_MILLILUX);
+
+        for (uint16_t i = 0; i < ClockBrightness::numberOfIndexes; i++) {
+            if (i <= darkIndex) {
+                levels[i] = 0;
+            } else if (i >= brightIndex) {
+                levels[i] = ClockBrightness::numberOfLevels - 1;
+            } else {
+                levels[i] = (i - darkIndex) * ClockBrightness::numberOfLevels / (brightIndex - darkIndex + 1);
+            }
+        }
+    }
+};
+
+static constexpr ClockBrightnessMap brightnessMap;
+
+static_assert(CONFIG_APP_BRIGHTNESS_DARK_MILLILUX < CONFIG_APP_BRIGHTNESS_BRIGHT_MILLILUX,
+    "The dark light level must be below the bright one");
+static_assert(brightnessMap.levels[ClockBrightness::numberOfIndexes - 1] == ClockBrightness::numberOfLevels - 1,
+    "The brightest light must have the highest level");
+
+bool ClockBrightness::update(uint32_t milliLux)
+{
+    lastIndex = getIndex(milliLux);
+
+    if (!ready) {
+        filteredIndex = lastIndex << filterScale;
+        level = brightnessMap.levels[lastIndex];
+        ready = true;
+
+        LOG_DBG("Brightness level: %u, index: %u", level, lastIndex);
+
+        return true;
+    }
+
+    int16_t difference = (int16_t)(lastIndex << filterScale) - (int16_t)filteredIndex;
+    int16_t step = difference / (1 << filterShift);
+
+    //the last fraction is added at once, so the filter always reaches the light level
+    filteredIndex += (step != 0) ? step : difference;
+
+    uint8_t index = filteredIndex >> filterScale;
+    uint8_t newLevel = brightnessMap.levels[index];
+
+    //the index must be far enough from the boundary of the current level
+    if ((newLevel > level) && (index >= hysteresis) && (brightnessMap.levels[index - hysteresis] > level)) {
+        level = newLevel;
+    } else if ((newLevel < level) && (index < (numberOfIndexes - hysteresis))
+        && (brightnessMap.levels[index + hysteresis] < level)) {
+        level = newLevel;
+    } else {
+        return false;
+    }
+
+    LOG_DBG("Brightness level: %u, index: %u", level, index);
+
+    return true;
+}
+
+uint8_t ClockBrightness::getBrightness()
+{
+    //the display takes the level from the high 4 bits
+    return level << 4;
+}
+
+bool ClockBrightness::isSettled()
+{
+    return ((filteredIndex >> filterScale) == lastIndex);
+}
+
+uint8_t ClockBrightness::getPowerSavingMode()
+{
+    return isSettled() ? CONFIG_APP_LIGHT_SENSOR_PSM_MODE : 0;
+}
@@ -1,5 +1,7 @@
 #include <ClockButtons.h>
 
+LOG_MODULE_REGISTER(clock_buttons, CONFIG_APP_BUTTONS_LOG_LEVEL);
+
 int64_t ClockButtons::lastPressedButtonTime = 0;
 uint8_t ClockButtons::lastPressedButtonId = 0;
 
@@ -10,7 +12,9 @@ gpio_callback ClockButtons::dateButtonCallbackData;
 gpio_callback ClockButtons::memoButtonCallbackData;
 gpio_callback ClockButtons::tempButtonCallbackData;
 
-struct k_fifo ClockButtons::pressedButtons;
+atomic_t ClockButtons::pressedCounts[ClockButtons::tempButtonId + 1];
+
+struct k_sem ClockButtons::pressedSemaphore;
 
 ClockButtons::ClockButtons(ClockSettings *clockSettings, ClockTime *clockTime, ClockDisplay *clockDisplay)
 {
@@ -18,8 +22,8 @@ ClockButtons::ClockButtons(ClockSettings *clockSettings, ClockTime *clockTime, C
     this->clockTime = clockTime;
     this->clockDisplay = clockDisplay;
 
-    printk("Init Buttons.\n");
-    k_fifo_init(&pressedButtons);
+    LOG_DBG("Init Buttons");
+    k_sem_init(&pressedSemaphore, 0, 1);
     
     const struct gpio_dt_spec hButton = GPIO_DT_SPEC_GET(DT_NODELABEL(button_h), gpios);
     const struct gpio_dt_spec minButton = GPIO_DT_SPEC_GET(DT_NODELABEL(button_min), gpios);
@@ -41,77 +45,102 @@ int ClockButtons::initButtonInterrupt(const struct gpio_dt_spec *button, struct
     gpio_callback_handler_t callbackFunction)
 {
     if (!device_is_ready(button->port)) {
-        printk("Error: Button device %s is not ready\n", button->port->name);
+        LOG_ERR("Error: Button device %s is not ready", button->port->name);
         return 1;
     }
 
     int ret = gpio_pin_configure_dt(button, GPIO_INPUT);
     if (ret != 0) {
-        printk("Error %d: failed to configure %s pin %d\n",
+        LOG_ERR("Error %d: failed to configure %s pin %d",
            ret, button->port->name, button->pin);
         return 1;
     }
 
     ret = gpio_pin_interrupt_configure_dt(button, GPIO_INT_EDGE_TO_ACTIVE);
     if (ret != 0) {
-        printk("Error %d: failed to configure interrupt on %s pin %d\n",
+        LOG_ERR("Error %d: failed to configure interrupt on %s pin %d",
             ret, button->port->name, button->pin);
         return 1;
     }
 
     gpio_init_callback(callback, callbackFunction, BIT(button->pin));
     gpio_add_callback(button->port, callback);
-    printk("Set up button at %s pin %d\n", button->port->name, button->pin);
+    LOG_DBG("Set up button at %s pin %d", button->port->name, button->pin);
 
     return 0;
 }
 
-void ClockButtons::processButtonActions()
+void ClockButtons::processButtonActions(ClockWatchdog *watchdog)
 {
-    struct pressedButton *eventPressedButton;
-
     while (1) {
-        eventPressedButton = (pressedButton*)k_fifo_get(&pressedButtons, K_FOREVER);
-        if (!eventPressedButton) {
-            k_msleep(50);
+        watchdog->feed();
+
+        //wakes up without a press to feed the watchdog
+        int ret = k_sem_take(&pressedSemaphore, watchdog->getWaitTimeout());
+
+        ClockMetrics::countWakeup();
+
+        if (ret != 0) {
             continue;
         }
 
-       printk("Received a button press %u\n", eventPressedButton->id);
-
-        switch(eventPressedButton->id) {
-            case hButtonId:
-                hButtonProcess();
-                break;
-            case minButtonId:
-                minButtonProcess();
-                break;
-            case dateButtonId:
-                //debounce the button
-                if (clockDisplay->getMode() != ClockDisplay::modeDate) {
-                    dateButtonProcess();
-                }
-                break;
-            case hourButtonId:
-                if (clockDisplay->getMode() != ClockDisplay::modeHour) {
-                    hourButtonProcess();
-                }
-                break;
-            case tempButtonId:
-                if (clockDisplay->getMode() != ClockDisplay::modeTemp) {
-                    tempButtonProcess();
-                }
-                break;
-            case memoButtonId:
-                memoButtonProcess();
-                break;
-            default:
-                printk("The button is not processed\n");
-                continue;
+        processPressedButtons();
+    }
+}
+
+void ClockButtons::processPressedButtons()
+{
+    bool marked = false;
+
+    for (uint8_t id = hButtonId; id <= tempButtonId; id++) {
+        //the presses that come during the processing are left for the next wakeup
+        atomic_val_t count = atomic_clear(&pressedCounts[id]);
+
+        if ((count > 0) && !marked) {
+            ClockLatency::mark(ClockLatency::stageButtons);
+            marked = true;
+        }
+
+        for (atomic_val_t press = 0; press < count; press++) {
+            processPressedButton(id);
         }
     }
 }
 
+void ClockButtons::processPressedButton(uint8_t id)
+{
+    LOG_DBG("Received a button press %u", id);
+
+    switch(id) {
+        case hButtonId:
+            hButtonProcess();
+            break;
+        case minButtonId:
+            minButtonProcess();
+            break;
+        case dateButtonId:
+            //debounce the button
+            if (clockDisplay->getMode() != ClockDisplay::modeDate) {
+                dateButtonProcess();
+            }
+            break;
+        case hourButtonId:
+            if (clockDisplay->getMode() != ClockDisplay::modeHour) {
+                hourButtonProcess();
+            }
+            break;
+        case tempButtonId:
+            tempButtonProcess();
+            break;
+        case memoButtonId:
+            memoButtonProcess();
+            break;
+        default:
+            LOG_WRN("The button is not processed");
+            break;
+    }
+}
+
 void ClockButtons::minButtonProcess(void)
 {
     if ((clockDisplay->getMode() == ClockDisplay::modeTime) || (clockDisplay->getMode() == ClockDisplay::modeMinute)) {
@@ -124,7 +153,7 @@ void ClockButtons::minButtonProcess(void)
 
         clockTime->setRtcTime();
 
-        printk("In minButtonProcess Time: %.2d:%.2d:%.2d\n", clockTime->getHour(), clockTime->getMinute(), clockTime->getSecond());
+        LOG_DBG("In minButtonProcess Time: %.2d:%.2d:%.2d", clockTime->getHour(), clockTime->getMinute(), clockTime->getSecond());
     } else if (clockDisplay->getMode() == ClockDisplay::modeHour) {
         processHourChange();
 /*
@@ -150,7 +179,7 @@ void ClockButtons::minButtonProcess(void)
         //write the new time to RTC
         clockTime->setRtcTime();
 
-        printk("In minButtonProcess Time: %.2d:%.2d:%.2d\n", clockTime->getHour(), clockTime->getMinute(), clockTime->getSecond());
+        LOG_DBG("In minButtonProcess Time: %.2d:%.2d:%.2d", clockTime->getHour(), clockTime->getMinute(), clockTime->getSecond());
 */
     } else if (clockDisplay->getMode() == ClockDisplay::modeYear) {
         //get the current time
@@ -158,28 +187,28 @@ void ClockButtons::minButtonProcess(void)
 
         uint16_t year = clockTime->getYear();
 
-        printk("Year: %4d\n", year);
+        LOG_DBG("Year: %4d", year);
 
         clockTime->setYear((year < 2099) ? year + 1 : 2021);
 
         //write the new time to RTC
         clockTime->setRtcTime();
 
-        printk("In minButtonProcess Year: %.4d\n", clockTime->getYear());
+        LOG_DBG("In minButtonProcess Year: %.4d", clockTime->getYear());
     } else if (clockDisplay->getMode() == ClockDisplay::modeMonth) {
         //get the current time
         clockTime->getRtcTime();
 
         uint8_t month = clockTime->getMonth();
 
-        printk("Month: %2d\n", month);
+        LOG_DBG("Month: %2d", month);
 
         clockTime->setMonth((month < 12) ? month + 1 : 1);
 
         //write the new time to RTC
         clockTime->setRtcTime();
 
-        printk("In minButtonProcess Month: %.2d\n", clockTime->getMonth());
+        LOG_DBG("In minButtonProcess Month: %.2d", clockTime->getMonth());
 
     } else if (clockDisplay->getMode() == ClockDisplay::modeDay) {
         //get the current time
@@ -188,14 +217,14 @@ void ClockButtons::minButtonProcess(void)
         uint8_t day = clockTime->getDay();
         uint8_t daysInMonth = clockTime->getDaysInMonth();
 
-        printk("Day: %2d, daysInMonth: %2d\n", day, daysInMonth);
+        LOG_DBG("Day: %2d, daysInMonth: %2d", day, daysInMonth);
 
         clockTime->setDay((day < (daysInMonth - 1)) ? day + 1 : 1);
 
         //write the new time to RTC
         clockTime->setRtcTime();
 
-        printk("In minButtonProcess Day: %.2d\n", clockTime->getDay());
+        LOG_DBG("In minButtonProcess Day: %.2d", clockTime->getDay());
 
     } else if (clockDisplay->getMode() == ClockDisplay::modeMinute) {
         //get the current time
@@ -203,7 +232,7 @@ void ClockButtons::minButtonProcess(void)
 
         uint8_t minute = clockTime->getMinute();
 
-        printk("Minute: %2d\n", minute);
+        LOG_DBG("Minute: %2d", minute);
 
         clockTime->setMinute((minute < 59) ? minute + 1 : 0);
         clockTime->setSecond(0);
@@ -211,11 +240,11 @@ void ClockButtons::minButtonProcess(void)
         //write the new time to RTC
         clockTime->setRtcTime();
 
-        printk("In minButtonProcess Minute: %.2d\n", clockTime->getMinute());
+        LOG_DBG("In minButtonProcess Minute: %.2d", clockTime->getMinute());
 
     } else if (clockDisplay->getMode() == ClockDisplay::modeDstWeek) {
         uint8_t week = clockTime->getTimezone()->getDstWeek();
-        printk("Week: %2d\n", week);
+        LOG_DBG("Week: %2d", week);
 
         clockTime->getTimezone()->setDstWeek((week < 4) ? week + 1 : 0);
 
@@ -224,11 +253,11 @@ void ClockButtons::minButtonProcess(void)
         //write the new settings to EEPROM
         clockSettings->save();
 
-        printk("In minButtonProcess DstWeek: %.2d\n", clockTime->getTimezone()->getDstWeek());
+        LOG_DBG("In minButtonProcess DstWeek: %.2d", clockTime->getTimezone()->getDstWeek());
 
     } else if (clockDisplay->getMode() == ClockDisplay::modeDstWeekday) {
         uint8_t weekday = clockTime->getTimezone()->getDstWeekday();
-        printk("Weekday: %2d\n", weekday);
+        LOG_DBG("Weekday: %2d", weekday);
 
         clockTime->getTimezone()->setDstWeekday((weekday < 6) ? weekday + 1 : 0);
 
@@ -237,11 +266,11 @@ void ClockButtons::minButtonProcess(void)
         //write the new settings to EEPROM
         clockSettings->save();
 
-        printk("In minButtonProcess DstWeekday: %.2d\n", clockTime->getTimezone()->getDstWeekday());
+        LOG_DBG("In minButtonProcess DstWeekday: %.2d", clockTime->getTimezone()->getDstWeekday());
 
     } else if (clockDisplay->getMode() == ClockDisplay::modeDstMonth) {
         uint8_t month = clockTime->getTimezone()->getDstMonth();
-        printk("Month: %2d\n", month);
+        LOG_DBG("Month: %2d", month);
 
         clockTime->getTimezone()->setDstMonth((month < 11) ? month + 1 : 0);
 
@@ -250,11 +279,11 @@ void ClockButtons::minButtonProcess(void)
         //write the new settings to EEPROM
         clockSettings->save();
 
-        printk("In minButtonProcess DstMonth: %.2d\n", clockTime->getTimezone()->getDstMonth());
+        LOG_DBG("In minButtonProcess DstMonth: %.2d", clockTime->getTimezone()->getDstMonth());
 
     } else if (clockDisplay->getMode() == ClockDisplay::modeDstHour) {
         uint8_t hour = clockTime->getTimezone()->getDstHour();
-        printk("Hour: %2d\n", hour);
+        LOG_DBG("Hour: %2d", hour);
 
         clockTime->getTimezone()->setDstHour((hour < 23) ? hour + 1 : 0);
 
@@ -263,19 +292,19 @@ void ClockButtons::minButtonProcess(void)
         //write the new settings to EEPROM
         clockSettings->save();
 
-        printk("In minButtonProcess DstHour: %.2d\n", clockTime->getTimezone()->getDstHour());
+        LOG_DBG("In minButtonProcess DstHour: %.2d", clockTime->getTimezone()->getDstHour());
 
     } else if (clockDisplay->getMode() == ClockDisplay::modeDstOffset) {
         int offset = clockTime->getTimezone()->getDstOffset();
-        printk("Offset: %2d\n", offset);
+        LOG_DBG("Offset: %2d", offset);
 
         uint8_t offsetNumber = clockTime->getTimezone()->getOffsetNumber(offset);
-        printk("Offset: %2d, number: %2d\n", offset, offsetNumber);
+        LOG_DBG("Offset: %2d, number: %2d", offset, offsetNumber);
 
         //calculate the new offset number
         offsetNumber = (offsetNumber < (clockTime->getTimezone()->getNumberOfOffsets() - 1)) ? offsetNumber + 1 : 0;
 
-        printk("New offset number: %2d\n", offsetNumber);
+        LOG_DBG("New offset number: %2d", offsetNumber);
 
         clockTime->getTimezone()->setDstOffset(clockTime->getTimezone()->getOffsetByNumber(offsetNumber));
 
@@ -284,10 +313,10 @@ void ClockButtons::minButtonProcess(void)
         //write the new settings to EEPROM
         clockSettings->save();
 
-        printk("In minButtonProcess DstOffset: %.2d\n", clockTime->getTimezone()->getDstOffset());
+        LOG_DBG("In minButtonProcess DstOffset: %.2d", clockTime->getTimezone()->getDstOffset());
     } else if (clockDisplay->getMode() == ClockDisplay::modeStdWeek) {
         uint8_t week = clockTime->getTimezone()->getStdWeek();
-        printk("Week: %2d\n", week);
+        LOG_DBG("Week: %2d", week);
 
         clockTime->getTimezone()->setStdWeek((week < 4) ? week + 1 : 0);
 
@@ -296,11 +325,11 @@ void ClockButtons::minButtonProcess(void)
         //write the new settings to EEPROM
         clockSettings->save();
 
-        printk("In minButtonProcess stdWeek: %.2d\n", clockTime->getTimezone()->getStdWeek());
+        LOG_DBG("In minButtonProcess stdWeek: %.2d", clockTime->getTimezone()->getStdWeek());
 
     } else if (clockDisplay->getMode() == ClockDisplay::modeStdWeekday) {
         uint8_t weekday = clockTime->getTimezone()->getStdWeekday();
-        printk("Weekday: %2d\n", weekday);
+        LOG_DBG("Weekday: %2d", weekday);
 
         clockTime->getTimezone()->setStdWeekday((weekday < 6) ? weekday + 1 : 0);
 
@@ -309,11 +338,11 @@ void ClockButtons::minButtonProcess(void)
         //write the new settings to EEPROM
         clockSettings->save();
 
-        printk("In minButtonProcess stdWeekday: %.2d\n", clockTime->getTimezone()->getStdWeekday());
+        LOG_DBG("In minButtonProcess stdWeekday: %.2d", clockTime->getTimezone()->getStdWeekday());
 
     } else if (clockDisplay->getMode() == ClockDisplay::modeStdMonth) {
         uint8_t month = clockTime->getTimezone()->getDstMonth();
-        printk("Month: %2d\n", month);
+        LOG_DBG("Month: %2d", month);
 
         clockTime->getTimezone()->setStdMonth((month < 11) ? month + 1 : 0);
 
@@ -322,11 +351,11 @@ void ClockButtons::minButtonProcess(void)
         //write the new settings to EEPROM
         clockSettings->save();
 
-        printk("In minButtonProcess stdMonth: %.2d\n", clockTime->getTimezone()->getStdMonth());
+        LOG_DBG("In minButtonProcess stdMonth: %.2d", clockTime->getTimezone()->getStdMonth());
 
     } else if (clockDisplay->getMode() == ClockDisplay::modeStdHour) {
         uint8_t hour = clockTime->getTimezone()->getStdHour();
-        printk("Hour: %2d\n", hour);
+        LOG_DBG("Hour: %2d", hour);
 
         clockTime->getTimezone()->setStdHour((hour < 23) ? hour + 1 : 0);
 
@@ -335,19 +364,19 @@ void ClockButtons::minButtonProcess(void)
         //write the new settings to EEPROM
         clockSettings->save();
 
-        printk("In minButtonProcess stdHour: %.2d\n", clockTime->getTimezone()->getStdHour());
+        LOG_DBG("In minButtonProcess stdHour: %.2d", clockTime->getTimezone()->getStdHour());
 
     } else if (clockDisplay->getMode() == ClockDisplay::modeStdOffset) {
         int offset = clockTime->getTimezone()->getStdOffset();
-        printk("Offset: %2d\n", offset);
+        LOG_DBG("Offset: %2d", offset);
 
         uint8_t offsetNumber = clockTime->getTimezone()->getOffsetNumber(offset);
-        printk("Offset: %2d, number: %2d\n", offset, offsetNumber);
+        LOG_DBG("Offset: %2d, number: %2d", offset, offsetNumber);
 
         //calculate the new offset number
         offsetNumber = (offsetNumber < (clockTime->getTimezone()->getNumberOfOffsets() - 1)) ? offsetNumber + 1 : 0;
 
-        printk("New offset number: %2d\n", offsetNumber);
+        LOG_DBG("New offset number: %2d", offsetNumber);
 
         clockTime->getTimezone()->setStdOffset(clockTime->getTimezone()->getOffsetByNumber(offsetNumber));
 
@@ -356,10 +385,10 @@ void ClockButtons::minButtonProcess(void)
         //write the new settings to EEPROM
         clockSettings->save();
 
-        printk("In minButtonProcess stdOffset: %.2d\n", clockTime->getTimezone()->getStdOffset());
+        LOG_DBG("In minButtonProcess stdOffset: %.2d", clockTime->getTimezone()->getStdOffset());
     } else if (clockDisplay->getMode() == ClockDisplay::modeHourlyAlarm) {
         bool hourlyAlarm = clockSettings->getHourlyAlarm();
-        printk("HourlyAlarm: %2d\n", hourlyAlarm);
+        LOG_DBG("HourlyAlarm: %2d", hourlyAlarm);
 
         //invert bool
         hourlyAlarm = !hourlyAlarm;
@@ -370,17 +399,17 @@ void ClockButtons::minButtonProcess(void)
         //enable or disable hourly interrupts
         clockTime->setAlarmInterrupt();
 
-        printk("In minButtonProcess hourlyAlarm: %.2d\n", clockSettings->getHourlyAlarm());
+        LOG_DBG("In minButtonProcess hourlyAlarm: %.2d", clockSettings->getHourlyAlarm());
     } else if (clockDisplay->getMode() == ClockDisplay::modeCorrectionOffset) {
         int8_t offset = clockTime->getCorrectionOffset();
-        printk("Time Correction Offset: %2d\n", offset);
+        LOG_DBG("Time Correction Offset: %2d", offset);
 
         //the offset is from -32 to +31
         clockTime->setCorrectionOffset((offset < 31) ? offset + 1 : -32);
 
-        printk("In minButtonProcess Correction Offset: %+.2d\n", clockTime->getCorrectionOffset());
+        LOG_DBG("In minButtonProcess Correction Offset: %+.2d", clockTime->getCorrectionOffset());
     } else if (clockDisplay->getMode() == ClockDisplay::modeLightSensorValue) {
-        printk("In minButtonProcess LightSensorValue. Do nothing, just display the value\n");
+        LOG_DBG("In minButtonProcess LightSensorValue. Do nothing, just display the value");
     }
 
     //update display immediately
@@ -404,7 +433,7 @@ void ClockButtons::hButtonProcess(void)
             //write the new time to RTC
             clockTime->setRtcTime();
 
-            printk("In hButtonProcess Time: %.2d:%.2d:%.2d\n", clockTime->getHour(), clockTime->getMinute(), clockTime->getSecond());
+            LOG_DBG("In hButtonProcess Time: %.2d:%.2d:%.2d", clockTime->getHour(), clockTime->getMinute(), clockTime->getSecond());
 */
             break;
         }
@@ -470,7 +499,7 @@ void ClockButtons::hButtonProcess(void)
 
 void ClockButtons::dateButtonProcess(void)
 {
-    printk("In dateButtonPress\n");
+    LOG_DBG("In dateButtonPress");
     clockDisplay->clearScreen();
 
     clockDisplay->setMode(ClockDisplay::modeDate);
@@ -479,7 +508,7 @@ void ClockButtons::dateButtonProcess(void)
 
 void ClockButtons::hourButtonProcess(void)
 {
-    printk("In hourButtonPress\n");
+    LOG_DBG("In hourButtonPress");
     clockDisplay->clearScreen();
 
     clockDisplay->setMode(ClockDisplay::modeTime);
@@ -490,16 +519,31 @@ void ClockButtons::hourButtonProcess(void)
 
 void ClockButtons::tempButtonProcess(void)
 {
-    printk("In tempButtonPress\n");
+    LOG_DBG("In tempButtonPress");
     clockDisplay->clearScreen();
 
-    clockDisplay->setMode(ClockDisplay::modeTemp);
+    //the next presses go through the trip statistics
+    switch (clockDisplay->getMode()) {
+        case ClockDisplay::modeTemp:
+            clockDisplay->setMode(ClockDisplay::modeTempMin);
+            break;
+        case ClockDisplay::modeTempMin:
+            clockDisplay->setMode(ClockDisplay::modeTempMax);
+            break;
+        case ClockDisplay::modeTempMax:
+            clockDisplay->setMode(ClockDisplay::modeTempTrend);
+            break;
+        default:
+            clockDisplay->setMode(ClockDisplay::modeTemp);
+            break;
+    }
+
     clockDisplay->show();
 }
 
 void ClockButtons::memoButtonProcess(void)
 {
-    printk("In memoButtonPress\n");
+    LOG_DBG("In memoButtonPress");
 
     clockDisplay->setMode(ClockDisplay::modeYear);
     clockDisplay->show();
@@ -518,7 +562,7 @@ void ClockButtons::processHourChange()
     //check if it's a day when Standard time changes to DST
     //then instead of changing from 1:00 to 2:00, change to 3:00
     if (clockTime->isStartDstWithinOneHourLocal(currentTimeLocal + 1 * 60 * 60)) {
-        printk("Starting DST withing 1 hour\n");
+        LOG_DBG("Starting DST withing 1 hour");
         hour += 1;
     }
 
@@ -527,6 +571,6 @@ void ClockButtons::processHourChange()
     //write the new time to RTC
     clockTime->setRtcTime();
 
-    printk("In minButtonProcess Time: %.2d:%.2d:%.2d\n", clockTime->getHour(), clockTime->getMinute(), clockTime->getSecond());
+    LOG_DBG("In minButtonProcess Time: %.2d:%.2d:%.2d", clockTime->getHour(), clockTime->getMinute(), clockTime->getSecond());
 
 }
@@ -1,16 +1,20 @@
 #include <ClockDisplay.h>
 #include <font_5x7.h>
 
+LOG_MODULE_REGISTER(clock_display, CONFIG_APP_DISPLAY_LOG_LEVEL);
+
 bool ClockDisplay::backgroundLightInterruptCalled = true;
 gpio_callback ClockDisplay::backgroundLightCallbackData;
 
-ClockDisplay::ClockDisplay(ClockSettings *clockSettings, ClockTime *clockTime, ClockTemperature *clockTemperature)
+ClockDisplay::ClockDisplay(ClockSettings *clockSettings, ClockTime *clockTime, ClockTemperature *clockTemperature,
+    ClockLightSensor *clockLightSensor)
 {
     struct display_capabilities capabilities;
 
     this->clockSettings = clockSettings;
     this->clockTime = clockTime;
     this->clockTemperature = clockTemperature;
+    this->clockLightSensor = clockLightSensor;
 
     k_mutex_init(&mutexDisplay);
 
@@ -23,13 +27,13 @@ ClockDisplay::ClockDisplay(ClockSettings *clockSettings, ClockTime *clockTime, C
     display = DEVICE_DT_GET(DT_COMPAT_GET_ANY_STATUS_OKAY(holtek_ht1632c));
 
     if (display == NULL) {
-        printk("Device HT1632C not found.\n");
+        LOG_ERR("Device HT1632C not found");
         return;
     }
 
     display_get_capabilities(display, &capabilities);
-    printk("Display width %d\n", capabilities.x_resolution);
-    printk("Display height %d\n", capabilities.y_resolution);
+    LOG_DBG("Display width %d", capabilities.x_resolution);
+    LOG_DBG("Display height %d", capabilities.y_resolution);
 
     //32 rows of 8-bit or 24 rows of 16-bit
     bufDesc.buf_size = displayWidth * capabilities.y_resolution;
@@ -45,17 +49,18 @@ ClockDisplay::ClockDisplay(ClockSettings *clockSettings, ClockTime *clockTime, C
 
 void ClockDisplay::show(bool showTitle)
 {
+    ClockLatency::mark(ClockLatency::stageShow);
+
     char displayStr[7];
     memset(displayStr, 0, sizeof(displayStr));
 
     if (mode == modeTime) {
         uint8_t hour = clockTime->getHour();
 
-        printk("showTime Time: %.2d:%.2d:%.2d", clockTime->getHour(), clockTime->getMinute(), clockTime->getSecond());        
-        printk(", Date: %.2d-%.2d-%.2d, Weekday: %.2d\n", clockTime->getYear(), clockTime->getMonth(), clockTime->getDay(), clockTime->getWeekday());
+        LOG_DBG("showTime Time: %.2d:%.2d:%.2d, Date: %.2d-%.2d-%.2d, Weekday: %.2d", clockTime->getHour(), clockTime->getMinute(), clockTime->getSecond(), clockTime->getYear(), clockTime->getMonth(), clockTime->getDay(), clockTime->getWeekday());
 
         //convert the hour to the 12-hour clock
-        if (this->clockSettings->formatHour == ClockSettings::formatHour12) {
+        if (this->clockSettings->getFormatHour() == ClockSettings::formatHour12) {
             hour %= 12;
             hour = ((hour == 0) ? 12 : hour);
         }
@@ -73,17 +78,38 @@ void ClockDisplay::show(bool showTitle)
         unsigned char degree = 248;
 
         //show the temperature in Fahrenheit
-        if (this->clockSettings->formatTemperature == ClockSettings::formatFahrenheit) {
+        if (this->clockSettings->getFormatTemperature() == ClockSettings::formatFahrenheit) {
             temperature = (int)(temperature * 1.8) + 32;
         }
 
         sprintf(displayStr, "%+.2d%c", temperature, degree);
-        printk("displayStr: %s\n", displayStr);
+        LOG_DBG("displayStr: %s", displayStr);
+        drawString(displayStr);
+    } else if ((mode == modeTempMin) || (mode == modeTempMax) || (mode == modeTempTrend)) {
+        ClockTemperatureHistory *history = clockTemperature->getHistory();
+        unsigned char degree = 248;
+
+        clearScreen();
+
+        if (showTitle) {
+            drawStringScrolling((mode == modeTempMin) ? "Min" : ((mode == modeTempMax) ? "Max" : "Trend"));
+        }
+
+        if (history->isEmpty()) {
+            sprintf(displayStr, "--%c", degree);
+        } else if (mode == modeTempMin) {
+            sprintf(displayStr, "%+.2d%c", convertTemperature(history->getMinimum()), degree);
+        } else if (mode == modeTempMax) {
+            sprintf(displayStr, "%+.2d%c", convertTemperature(history->getMaximum()), degree);
+        } else {
+            sprintf(displayStr, "%+d%c", convertTemperature(history->getTrend(), true), degree);
+        }
+
         drawString(displayStr);
     } else if (mode == modeYear) {
         //skip double show of the screen
         if (showTitle && (previousMode == modeYear)) {
-            printk("Double year screen protection\n");
+            LOG_DBG("Double year screen protection");
             return;
         }
         previousMode = modeYear;
@@ -170,10 +196,10 @@ void ClockDisplay::show(bool showTitle)
 
         int offset = clockTime->getTimezone()->getDstOffset();
 
-        printk("Offset: %d\n", offset);
+        LOG_DBG("Offset: %d", offset);
 
         sprintf(displayStr, "%+.2hd.%.2hu", offset/60, abs(offset)%60);
-        printk("displayStr: %s\n", displayStr);
+        LOG_DBG("displayStr: %s", displayStr);
         drawString(displayStr);
     } else if (mode == modeStdWeek) {
         clearScreen();
@@ -216,10 +242,10 @@ void ClockDisplay::show(bool showTitle)
 
         int offset = clockTime->getTimezone()->getStdOffset();
 
-        printk("Offset: %d\n", offset);
+        LOG_DBG("Offset: %d", offset);
 
         sprintf(displayStr, "%+.2hd.%.2hu", offset/60, abs(offset)%60);
-        printk("displayStr: %s\n", displayStr);
+        LOG_DBG("displayStr: %s", displayStr);
         drawString(displayStr);
     } else if (mode == modeHourlyAlarm) {
         if (showTitle) {
@@ -230,10 +256,10 @@ void ClockDisplay::show(bool showTitle)
 
         bool hourlyAlarm = clockSettings->getHourlyAlarm();
 
-        printk("HourlyAlarm: %d\n", hourlyAlarm);
+        LOG_DBG("HourlyAlarm: %d", hourlyAlarm);
 
         sprintf(displayStr, "%s", (hourlyAlarm ? "Yes" : "No "));
-        printk("displayStr: %s\n", displayStr);
+        LOG_DBG("displayStr: %s", displayStr);
 
         drawString(displayStr);
     } else if (mode == modeCorrectionOffset) {
@@ -245,10 +271,10 @@ void ClockDisplay::show(bool showTitle)
 
         int8_t offset = clockTime->getCorrectionOffset();
 
-        printk("Time Correction Offset (+ faster or - slower): %d\n", offset);
+        LOG_DBG("Time Correction Offset (+ faster or - slower): %d", offset);
 
         sprintf(displayStr, "%+.2d", offset);
-        printk("displayStr: %s\n", displayStr);
+        LOG_DBG("displayStr: %s", displayStr);
         drawString(displayStr);
     } else if (mode == modeLightSensorValue) {
         if (showTitle) {
@@ -257,11 +283,11 @@ void ClockDisplay::show(bool showTitle)
 
         clearScreen();
 
-        ClockLightSensor lightSensor;
-        uint8_t lux = lightSensor.getLightLux();
-        sprintf(displayStr, "%04u", lux);
+        //the cached sample is shown if it is not older than the sensor integration time
+        uint32_t lux = MIN(clockLightSensor->getLightMilliLux() / 1000, 9999);
+        sprintf(displayStr, "%04u", (unsigned int)lux);
 
-        printk("displayStr: %s\n", displayStr);
+        LOG_DBG("displayStr: %s", displayStr);
         drawString(displayStr);
     }
 
@@ -273,13 +299,13 @@ void ClockDisplay::render()
 /*
     //if the background light interrupt was called
     if (backgroundLightInterruptCalled) {
-        printk("backgroundLightInterruptCalled was On\n");
+        LOG_DBG("backgroundLightInterruptCalled was On");
 
         const struct gpio_dt_spec lightSensor = getBackgroundLightSensor();
 
         int level = gpio_pin_get_dt(&lightSensor);
 
-        printk("Input Level: %d\n", level);
+        LOG_DBG("Input Level: %d", level);
 
         backgroundLightOn = (level ? true : false);
 
@@ -292,11 +318,22 @@ void ClockDisplay::render()
     //wait for milleseconds until the display is free
     //if not, if can display the time later
     if (k_mutex_lock(&mutexDisplay, K_MSEC(300)) == 0) {
+        uint32_t start = ClockMetrics::startTimer();
+
+        ClockLatency::mark(ClockLatency::stageRender);
+
         display_write(display, 0, 0, &bufDesc, bufDisplay);
 
+        ClockLatency::mark(ClockLatency::stageWritten);
+
+        ClockMetrics::recordTime(ClockMetrics::histogramDisplayWriteTime, start);
+        ClockMetrics::count(ClockMetrics::counterDisplayWrites);
+        ClockMetrics::count(ClockMetrics::counterDisplayBytes, bufDesc.buf_size);
+
         k_mutex_unlock(&mutexDisplay);
     } else {
-        printk("Mutex timeout\n");
+        ClockMetrics::count(ClockMetrics::counterMutexTimeouts);
+        LOG_WRN("Mutex timeout");
     }
 
 }
@@ -326,11 +363,11 @@ void ClockDisplay::drawChar(uint8_t c, uint8_t x)
         c -= ' ';
     }
 
-    //printk("Character index: %d\n", c);
+    //LOG_DBG("Character index: %d", c);
 
     for (int i = x, j = 0; j < fontWidth; i++, j++) {
         bufDisplay[i] = font[c][j];
-        //printk("i: %d, j: %d, char: %x\n", i, j, (unsigned char)font[c][j]);
+        //LOG_DBG("i: %d, j: %d, char: %x", i, j, (unsigned char)font[c][j]);
     }
 }
 
@@ -379,7 +416,7 @@ void ClockDisplay::drawStringScrolling(const char *displayStr)
 
         for (uint8_t i = k; i < k + numberOfIndicators; i++) {
 
-            printk("k: %d, i: %d, c: %c\n", k, i, displayStr[i]);
+            LOG_DBG("k: %d, i: %d, c: %c", k, i, displayStr[i]);
             drawChar(displayStr[i], x);
 
             if (displayStr[i] == '\0') {
@@ -402,7 +439,34 @@ void ClockDisplay::drawStringScrolling(const char *displayStr)
  */
 void ClockDisplay::setBrightness(uint8_t brightness)
 {
-    printk("Setting brightness %u\n", (unsigned int)brightness);
+    automaticBrightness = brightness;
+
+    //the override keeps the display level until it is removed
+    if (getBrightnessOverride() != brightnessAutomatic) {
+        return;
+    }
+
+    writeBrightness(brightness);
+}
+
+/**
+ * Sets the brightness that replaces the one from the light level
+ *
+ * @param int16_t brightness The brightness between 0 and 255 or brightnessAutomatic to remove the override
+ */
+void ClockDisplay::setBrightnessOverride(int16_t brightness)
+{
+    atomic_set(&brightnessOverride, brightness);
+
+    writeBrightness((brightness != brightnessAutomatic) ? brightness : automaticBrightness);
+}
+
+/**
+ * Writes the brightness to the display
+ */
+void ClockDisplay::writeBrightness(uint8_t brightness)
+{
+    LOG_DBG("Setting brightness %u", (unsigned int)brightness);
 
     if (k_mutex_lock(&mutexDisplay, K_MSEC(300)) == 0) {
         //accepts the value between 0 and 255
@@ -411,7 +475,7 @@ void ClockDisplay::setBrightness(uint8_t brightness)
         k_mutex_unlock(&mutexDisplay);
     }
 
-    printk("After setting brightness\n");
+    LOG_DBG("After setting brightness");
 
 }
 
@@ -450,21 +514,21 @@ int ClockDisplay::initBackgroundLightInterrupt()
     const struct gpio_dt_spec gpio = getBackgroundLightSensor();
 
     if (!device_is_ready(gpio.port)) {
-        printk("Error: GPIO light device %s is not ready\n", gpio.port->name);
+        LOG_ERR("Error: GPIO light device %s is not ready", gpio.port->name);
         return 1;
     }
 
     //active when the level is low
     int ret = gpio_pin_configure_dt(&gpio, GPIO_INPUT | GPIO_ACTIVE_LOW | GPIO_PULL_UP);
     if (ret != 0) {
-        printk("Error %d: failed to configure %s pin %d\n",
+        LOG_ERR("Error %d: failed to configure %s pin %d",
            ret, gpio.port->name, gpio.pin);
         return 1;
     }
 
     ret = gpio_pin_interrupt_configure_dt(&gpio, GPIO_INT_EDGE_BOTH);
     if (ret != 0) {
-        printk("Error %d: failed to configure interrupt on %s pin %d\n",
+        LOG_ERR("Error %d: failed to configure interrupt on %s pin %d",
             ret, gpio.port->name, gpio.pin);
         return 1;
     }
@@ -472,13 +536,13 @@ int ClockDisplay::initBackgroundLightInterrupt()
     gpio_init_callback(&backgroundLightCallbackData, backgroundLightChanged, BIT(gpio.pin));
     gpio_add_callback(gpio.port, &backgroundLightCallbackData);
 
-    printk("Set up background light GPIO at %s pin %d\n", gpio.port->name, gpio.pin);
+    LOG_DBG("Set up background light GPIO at %s pin %d", gpio.port->name, gpio.pin);
 
     uint8_t levelRaw = gpio_pin_get_raw(gpio.port, gpio.pin);
-    printk("\nLevelRaw: %u\n", levelRaw);
+    LOG_DBG("LevelRaw: %u", levelRaw);
 
     int level = gpio_pin_get_dt(&gpio);
-    printk("\nLevel: %d\n", level);
+    LOG_DBG("Level: %d", level);
 
     //check the background light sensor level the first time
     backgroundLightInterruptCalled = true;
@@ -490,8 +554,23 @@ void ClockDisplay::backgroundLightChanged(const struct device *dev, struct gpio_
 {
     backgroundLightInterruptCalled = true;
 
-    printk("Background light GPIO interrupt: %s, pins: %zu\n", dev->name, pins);
+    LOG_DBG("Background light GPIO interrupt: %s, pins: %zu", dev->name, pins);
+}
+
+/**
+ * Converts the temperature in tenths of a degree Celsius to the whole degrees of the temperature format
+ */
+int ClockDisplay::convertTemperature(int temperature, bool difference)
+{
+    //show the temperature in Fahrenheit
+    if (this->clockSettings->getFormatTemperature() == ClockSettings::formatFahrenheit) {
+        temperature = temperature * 9 / 5 + (difference ? 0 : 320);
+    }
+
+    //round to the whole degrees
+    return (temperature + ((temperature < 0) ? -5 : 5)) / 10;
 }
+
 /**
  * Gets the sleep time for the display depending on the data displayed
  */
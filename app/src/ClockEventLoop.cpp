@@ -0,0 +1,28 @@
+#include <ClockEventLoop.h>
+
+atomic_t ClockEventLoop::pending = ATOMIC_INIT(0);
+
+struct k_sem ClockEventLoop::wake;
+
+void ClockEventLoop::init()
+{
+    k_sem_init(&wake, 0, 1);
+}
+
+void ClockEventLoop::post(uint32_t events)
+{
+    if (!IS_ENABLED(CONFIG_APP_EVENT_LOOP)) {
+        return;
+    }
+
+    atomic_or(&pending, events);
+    k_sem_give(&wake);
+}
+
+uint32_t ClockEventLoop::wait(k_timeout_t timeout)
+{
+    //the events posted after the clear give the semaphore again, so they are taken by the next wait
+    k_sem_take(&wake, timeout);
+
+    return atomic_clear(&pending);
+}
@@ -1,5 +1,7 @@
 #include <ClockGong.h>
 
+LOG_MODULE_REGISTER(clock_gong, CONFIG_APP_TIME_LOG_LEVEL);
+
 ClockGong::ClockGong()
 {
 }
@@ -8,23 +10,23 @@ void ClockGong::playT1()
 {
     int ret = 0;
 
-    printk("Playing gong T1\n");
+    LOG_DBG("Playing gong T1");
     const struct gpio_dt_spec gongT1 = GPIO_DT_SPEC_GET(DT_PATH(bmw_gong), t1_gpios);
 
     if (!device_is_ready(gongT1.port)) {
-        printk("Error: GPIO gongT1 %s is not ready\n", gongT1.port->name);
+        LOG_ERR("Error: GPIO gongT1 %s is not ready", gongT1.port->name);
     } else {    
         //active when the level is low
         ret = gpio_pin_configure_dt(&gongT1, GPIO_OUTPUT_LOW);
         if (ret != 0) {
-            printk("Error %d: failed to configure %s pin %d\n",
+            LOG_ERR("Error %d: failed to configure %s pin %d",
                 ret, gongT1.port->name, gongT1.pin);
         }
     }
 
     ret = gpio_pin_set_dt(&gongT1, 1);
     if (ret != 0) {
-        printk("Error %d: pin set T1 %s pin %d\n",
+        LOG_ERR("Error %d: pin set T1 %s pin %d",
             ret, gongT1.port->name, gongT1.pin);
     }
 
@@ -32,7 +34,7 @@ void ClockGong::playT1()
 
     ret = gpio_pin_set_dt(&gongT1, 0);
     if (ret != 0) {
-        printk("Error %d: pin set T1 %s pin %d\n",
+        LOG_ERR("Error %d: pin set T1 %s pin %d",
             ret, gongT1.port->name, gongT1.pin);
     }
 
@@ -42,23 +44,23 @@ void ClockGong::playT2()
 {
     int ret = 0;
 
-    printk("Playing gong T2\n");
+    LOG_DBG("Playing gong T2");
     const struct gpio_dt_spec gongT2 = GPIO_DT_SPEC_GET(DT_PATH(bmw_gong), t2_gpios);
 
     if (!device_is_ready(gongT2.port)) {
-        printk("Error: GPIO gongT2 %s is not ready\n", gongT2.port->name);
+        LOG_ERR("Error: GPIO gongT2 %s is not ready", gongT2.port->name);
     } else {    
         //active when the level is low
         ret = gpio_pin_configure_dt(&gongT2, GPIO_OUTPUT_LOW);
         if (ret != 0) {
-            printk("Error %d: failed to configure %s pin %d\n",
+            LOG_ERR("Error %d: failed to configure %s pin %d",
                 ret, gongT2.port->name, gongT2.pin);
         }
     }
 
     ret = gpio_pin_set_dt(&gongT2, 1);
     if (ret != 0) {
-        printk("Error %d: pin set T2 %s pin %d\n",
+        LOG_ERR("Error %d: pin set T2 %s pin %d",
             ret, gongT2.port->name, gongT2.pin);
     }
 
@@ -66,7 +68,7 @@ void ClockGong::playT2()
 
     ret = gpio_pin_set_dt(&gongT2, 0);
     if (ret != 0) {
-        printk("Error %d: pin set T2 %s pin %d\n",
+        LOG_ERR("Error %d: pin set T2 %s pin %d",
             ret, gongT2.port->name, gongT2.pin);
     }
 }
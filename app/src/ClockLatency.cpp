@@ -0,0 +1,177 @@
+#include <ClockLatency.h>
+
+LOG_MODULE_REGISTER(clock_latency, CONFIG_APP_LOG_LEVEL);
+
+const char *const ClockLatency::stageNames[ClockLatency::numberOfStages] = {"interrupt", "buttons", "show",
+    "render", "written"};
+
+atomic_t ClockLatency::active = ATOMIC_INIT(0);
+
+uint32_t ClockLatency::stamps[ClockLatency::numberOfStages];
+
+uint32_t ClockLatency::markedStages = 0;
+
+k_tid_t ClockLatency::traceThread = NULL;
+
+#ifdef CONFIG_APP_LATENCY_TRACE
+uint32_t ClockLatency::samples[CONFIG_APP_LATENCY_TRACE_SAMPLES][ClockLatency::numberOfStages - 1];
+#endif
+
+uint16_t ClockLatency::numberOfSamples = 0;
+
+uint16_t ClockLatency::nextSample = 0;
+
+struct k_spinlock ClockLatency::lock;
+
+void ClockLatency::init()
+{
+    if (!IS_ENABLED(CONFIG_APP_LATENCY_TRACE)) {
+        return;
+    }
+
+    //the DWT counts only while the trace unit is enabled
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    LOG_INF("The latency trace is started, %u cycles/s", SystemCoreClock);
+}
+
+void ClockLatency::markStage(uint8_t stage, uint32_t cycles)
+{
+#ifdef CONFIG_APP_LATENCY_TRACE
+    if ((stage <= stageInterrupt) || (stage >= numberOfStages)) {
+        return;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    //every stage is marked once and only after the previous one
+    if (!(markedStages & BIT(stage - 1)) || (markedStages & BIT(stage))) {
+        k_spin_unlock(&lock, key);
+        return;
+    }
+
+    if (stage == stageButtons) {
+        traceThread = k_current_get();
+    } else if (k_current_get() != traceThread) {
+        k_spin_unlock(&lock, key);
+        return;
+    }
+
+    stamps[stage] = cycles;
+    markedStages |= BIT(stage);
+
+    //the display was written, the trace is complete
+    if (stage == stageWritten) {
+        for (uint8_t i = stageButtons; i < numberOfStages; i++) {
+            //the cycle difference is correct across a counter wrap
+            samples[nextSample][i - 1] = stamps[i] - stamps[stageInterrupt];
+        }
+
+        nextSample = (nextSample + 1) % CONFIG_APP_LATENCY_TRACE_SAMPLES;
+
+        if (numberOfSamples < CONFIG_APP_LATENCY_TRACE_SAMPLES) {
+            numberOfSamples++;
+        }
+
+        atomic_set(&active, 0);
+    }
+
+    k_spin_unlock(&lock, key);
+#endif
+}
+
+uint32_t ClockLatency::toMicroseconds(uint32_t cycles)
+{
+    return (uint32_t)(((uint64_t)cycles * USEC_PER_SEC) / SystemCoreClock);
+}
+
+void ClockLatency::dump(const struct shell *sh)
+{
+#ifdef CONFIG_APP_LATENCY_TRACE
+    uint32_t values[CONFIG_APP_LATENCY_TRACE_SAMPLES];
+
+    shell_print(sh, "%-10s %8s %8s %8s %8s (us from the interrupt)", "stage", "p50", "p90", "p99", "max");
+
+    for (uint8_t stage = stageButtons; stage < numberOfStages; stage++) {
+        k_spinlock_key_t key = k_spin_lock(&lock);
+
+        uint16_t count = numberOfSamples;
+
+        for (uint16_t i = 0; i < count; i++) {
+            values[i] = samples[i][stage - 1];
+        }
+
+        k_spin_unlock(&lock, key);
+
+        if (count == 0) {
+            shell_print(sh, "%-10s no traces", stageNames[stage]);
+            continue;
+        }
+
+        //the insertion sort is enough for the few traces
+        for (uint16_t i = 1; i < count; i++) {
+            uint32_t value = values[i];
+            uint16_t j = i;
+
+            while ((j > 0) && (values[j - 1] > value)) {
+                values[j] = values[j - 1];
+                j--;
+            }
+
+            values[j] = value;
+        }
+
+        shell_print(sh, "%-10s %8u %8u %8u %8u", stageNames[stage], toMicroseconds(values[(count - 1) * 50 / 100]),
+            toMicroseconds(values[(count - 1) * 90 / 100]), toMicroseconds(values[(count - 1) * 99 / 100]),
+            toMicroseconds(values[count - 1]));
+    }
+
+    shell_print(sh, "traces: %u", numberOfSamples);
+#endif
+}
+
+void ClockLatency::reset()
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    numberOfSamples = 0;
+    nextSample = 0;
+
+    k_spin_unlock(&lock, key);
+
+    LOG_INF("The latency traces were cleared");
+}
+
+#if defined(CONFIG_SHELL) && defined(CONFIG_APP_LATENCY_TRACE)
+/**
+ * Prints the percentiles of the stored traces
+ */
+static int latencyShow(const struct shell *sh, size_t argc, char **argv)
+{
+    ClockLatency::dump(sh);
+
+    return 0;
+}
+
+/**
+ * Clears the stored traces
+ */
+static int latencyReset(const struct shell *sh, size_t argc, char **argv)
+{
+    ClockLatency::reset();
+
+    shell_print(sh, "The latency traces were cleared");
+
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(latencyCommands,
+    SHELL_CMD(show, NULL, "Print the percentiles of the button to display latency", latencyShow),
+    SHELL_CMD(reset, NULL, "Clear the latency traces", latencyReset),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(latency, &latencyCommands, "Button to display latency trace", latencyShow);
+#endif
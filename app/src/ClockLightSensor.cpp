@@ -1,74 +1,204 @@
 #include <ClockLightSensor.h>
 
-const ClockLightBrightness ClockLightSensor::brightnessLookupTable[] = {
-    {0, 0, 4},
-    {16, 4, 8},
-    {32, 8, 12},
-    {48, 12, 16},
-    {64, 16, 20},
-    {80, 20, 24},
-    {96, 24, 28},
-    {112, 28, 32},
-    {128, 32, 36},
-    {144, 36, 40},
-    {160, 40, 44},
-    {176, 44, 48},
-    {192, 48, 52},
-    {208, 52, 56},
-    {224, 56, 60},
-    {255, 60, 100000},
-};
+LOG_MODULE_REGISTER(clock_light_sensor, CONFIG_APP_SENSORS_LOG_LEVEL);
+
+ClockLightSensor *ClockLightSensor::waitingSensor = NULL;
 
 ClockLightSensor::ClockLightSensor()
 {
-    printk("Init Device VEML.\n");
+    k_mutex_init(&mutexSensor);
+    k_sem_init(&lightChanged, 0, 1);
+
+    LOG_DBG("Init Device VEML");
 
     sensor = DEVICE_DT_GET(DT_INST(0, vishay_veml7700));
     
     if (!sensor) {
-        printk("Device VEML not found.\n");
+        LOG_ERR("Device VEML not found");
         return;
     }
 }
 
-uint32_t ClockLightSensor::getLightLux()
+uint32_t ClockLightSensor::getRefreshPeriod()
+{
+    struct sensor_value frequency;
+
+    if ((sensor_attr_get(sensor, SENSOR_CHAN_LIGHT, SENSOR_ATTR_SAMPLING_FREQUENCY, &frequency) != 0)
+        || ((frequency.val1 == 0) && (frequency.val2 == 0))) {
+        return defaultRefreshPeriod;
+    }
+
+    //the frequency is in micro Hz
+    return 1000000000ULL / ((uint64_t)frequency.val1 * 1000000 + frequency.val2);
+}
+
+int ClockLightSensor::fetch()
 {
     struct sensor_value val;
 
-    printk("Get lightLux.\n");
+    if (sensor_sample_fetch(sensor) < 0) {
+        LOG_ERR("sample update error");
+        return -EIO;
+    }
+
+    if (sensor_channel_get(sensor, SENSOR_CHAN_LIGHT, &val) < 0) {
+        LOG_ERR("ALS read error");
+        return -EIO;
+    }
+
+    LOG_DBG("Light (lux): %d.%06d", val.val1, val.val2);
+
+    lastLight = (uint32_t)val.val1 * 1000 + val.val2 / 1000;
+    lastSampleTime = k_uptime_get();
+    sampleReady = true;
+
+    return 0;
+}
+
+uint32_t ClockLightSensor::getLightMilliLux()
+{
+    LOG_DBG("Get light");
 
     if (!sensor) {
         return 0;
     }
 
-    if (sensor_sample_fetch(sensor) < 0) {
-        printk("sample update error.\n");
-        return 0;
-    } else {
-        if (sensor_channel_get(sensor, SENSOR_CHAN_LIGHT, &val) < 0) {
-            printk("ALS read error.\n");
-            return 0;
-        } else {
-            printk("Light (lux)1: %d\n", (uint32_t)val.val1);
-            return ((uint32_t)val.val1);
+    //the other thread is fetching, its sample is recent enough
+    if (k_mutex_lock(&mutexSensor, K_MSEC(300)) != 0) {
+        ClockMetrics::count(ClockMetrics::counterMutexTimeouts);
+        return lastLight;
+    }
+
+    if (!sampleReady || ((k_uptime_get() - lastSampleTime) >= getRefreshPeriod())) {
+        if (fetch() != 0) {
+            lastLight = 0;
+            sampleReady = false;
         }
     }
+
+    uint32_t light = lastLight;
+
+    k_mutex_unlock(&mutexSensor);
+
+    return light;
+}
+
+void ClockLightSensor::thresholdTriggered(const struct device *dev, const struct sensor_trigger *trigger)
+{
+    if (IS_ENABLED(CONFIG_APP_EVENT_LOOP)) {
+        ClockEventLoop::post(ClockEventLoop::eventLight);
+    } else if (waitingSensor != NULL) {
+        k_sem_give(&waitingSensor->lightChanged);
+    }
 }
 
-uint8_t ClockLightSensor::getBrightness()
+int ClockLightSensor::startWatch()
 {
-    uint32_t luxValue = getLightLux();
+    struct sensor_trigger trigger = {
+        .type = SENSOR_TRIG_THRESHOLD,
+        .chan = SENSOR_CHAN_LIGHT,
+    };
+    struct sensor_value lower, upper;
 
-    uint8_t brightness = 0;
+    if (!sensor) {
+        return -ENODEV;
+    }
 
-    for (uint8_t i = 0; i < sizeof(brightnessLookupTable)/sizeof(brightnessLookupTable[0]); i++) {
-        if ((luxValue >= brightnessLookupTable[i].from) && (luxValue <= brightnessLookupTable[i].to)) {
-            brightness = brightnessLookupTable[i].brightness;
-            break;
-        }
+    if (k_mutex_lock(&mutexSensor, K_MSEC(300)) != 0) {
+        ClockMetrics::count(ClockMetrics::counterMutexTimeouts);
+        return -EBUSY;
+    }
+
+    uint32_t margin = MAX(lastLight >> thresholdShift, thresholdMinimum);
+
+    uint32_t lowerLight = (lastLight > margin) ? (lastLight - margin) : 0;
+    uint32_t upperLight = lastLight + margin;
+
+    lower.val1 = lowerLight / 1000;
+    lower.val2 = (lowerLight % 1000) * 1000;
+    upper.val1 = upperLight / 1000;
+    upper.val2 = (upperLight % 1000) * 1000;
+
+    k_sem_reset(&lightChanged);
+    waitingSensor = this;
+
+    int ret = sensor_attr_set(sensor, SENSOR_CHAN_LIGHT, SENSOR_ATTR_LOWER_THRESH, &lower);
+    if (ret == 0) {
+        ret = sensor_attr_set(sensor, SENSOR_CHAN_LIGHT, SENSOR_ATTR_UPPER_THRESH, &upper);
+    }
+    if (ret == 0) {
+        ret = sensor_trigger_set(sensor, &trigger, thresholdTriggered);
+    }
+
+    k_mutex_unlock(&mutexSensor);
+
+    if (ret == 0) {
+        LOG_DBG("Waiting for the light out of %u-%u mlx", lowerLight, upperLight);
+    }
+
+    return ret;
+}
+
+void ClockLightSensor::stopWatch()
+{
+    struct sensor_trigger trigger = {
+        .type = SENSOR_TRIG_THRESHOLD,
+        .chan = SENSOR_CHAN_LIGHT,
+    };
+
+    if (!sensor) {
+        return;
+    }
+
+    if (k_mutex_lock(&mutexSensor, K_FOREVER) == 0) {
+        sensor_trigger_set(sensor, &trigger, NULL);
+        k_mutex_unlock(&mutexSensor);
+    }
+}
+
+bool ClockLightSensor::waitForChange(k_timeout_t timeout)
+{
+    //without the trigger it is the old polling
+    if (startWatch() != 0) {
+        k_sleep(timeout);
+        return false;
+    }
+
+    bool changed = (k_sem_take(&lightChanged, timeout) == 0);
+
+    //stop checking the sensor while the light is processed
+    stopWatch();
+
+    return changed;
+}
+
+int ClockLightSensor::setPowerSaving(uint8_t mode)
+{
+    struct sensor_value value = {
+        .val1 = mode,
+        .val2 = 0,
+    };
+
+    if (!sensor) {
+        return -ENODEV;
+    }
+
+    if (mode == powerSavingMode) {
+        return 0;
+    }
+
+    if (k_mutex_lock(&mutexSensor, K_MSEC(300)) != 0) {
+        ClockMetrics::count(ClockMetrics::counterMutexTimeouts);
+        return -EBUSY;
+    }
+
+    int ret = sensor_attr_set(sensor, SENSOR_CHAN_LIGHT, (enum sensor_attribute)SENSOR_ATTR_VEML7700_PSM, &value);
+    if (ret == 0) {
+        powerSavingMode = mode;
+        LOG_DBG("Light sensor power saving mode: %u", mode);
     }
 
-    printk("Display Brightness: %u\n", brightness);
+    k_mutex_unlock(&mutexSensor);
 
-    return brightness;
+    return ret;
 }
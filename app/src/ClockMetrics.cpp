@@ -0,0 +1,194 @@
+#include <ClockMetrics.h>
+
+#include <zephyr/shell/shell.h>
+
+#include <driver_rtc.h>
+#include <driver_veml7700.h>
+
+LOG_MODULE_REGISTER(clock_metrics, CONFIG_APP_LOG_LEVEL);
+
+const char *const ClockMetrics::counterNames[ClockMetrics::numberOfCounters] = {"i2c rtc",
+    "i2c light sensor", "i2c eeprom", "rtc reads", "eeprom writes", "display writes", "display bytes",
+    "button events", "button debounced", "wakeups", "mutex timeouts"};
+
+const char *const ClockMetrics::histogramNames[ClockMetrics::numberOfHistograms] = {"display write us",
+    "rtc read us", "eeprom write us", "wakeups per hour"};
+
+atomic_t ClockMetrics::counters[ClockMetrics::numberOfCounters];
+
+ClockMetricsHistogram ClockMetrics::histograms[ClockMetrics::numberOfHistograms];
+
+struct k_spinlock ClockMetrics::lock;
+
+uint32_t ClockMetrics::wakeupHour = 0;
+
+uint32_t ClockMetrics::hourWakeups = 0;
+
+/**
+ * Adds the value to the histogram, the lock must be held
+ */
+static void addToHistogram(ClockMetricsHistogram *histogram, uint32_t value)
+{
+    if ((histogram->count == 0) || (value < histogram->minimum)) {
+        histogram->minimum = value;
+    }
+
+    if ((histogram->count == 0) || (value > histogram->maximum)) {
+        histogram->maximum = value;
+    }
+
+    histogram->count++;
+    histogram->sum += value;
+}
+
+void ClockMetrics::record(uint8_t histogram, uint32_t value)
+{
+    if (!IS_ENABLED(CONFIG_APP_METRICS) || (histogram >= numberOfHistograms)) {
+        return;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    addToHistogram(&histograms[histogram], value);
+
+    k_spin_unlock(&lock, key);
+}
+
+void ClockMetrics::countWakeup()
+{
+    if (!IS_ENABLED(CONFIG_APP_METRICS)) {
+        return;
+    }
+
+    count(counterWakeups);
+
+    uint32_t hour = k_uptime_get() / (60 * 60 * MSEC_PER_SEC);
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    //the first wakeup of a new hour closes the previous one
+    if (hour != wakeupHour) {
+        addToHistogram(&histograms[histogramWakeupsPerHour], hourWakeups);
+
+        wakeupHour = hour;
+        hourWakeups = 0;
+    }
+
+    hourWakeups++;
+
+    k_spin_unlock(&lock, key);
+}
+
+uint32_t ClockMetrics::getCounter(uint8_t counter)
+{
+    return (counter < numberOfCounters) ? atomic_get(&counters[counter]) : 0;
+}
+
+ClockMetricsHistogram ClockMetrics::getHistogram(uint8_t histogram)
+{
+    ClockMetricsHistogram copy = {};
+
+    if (histogram >= numberOfHistograms) {
+        return copy;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    copy = histograms[histogram];
+
+    k_spin_unlock(&lock, key);
+
+    return copy;
+}
+
+const char *ClockMetrics::getCounterName(uint8_t counter)
+{
+    return (counter < numberOfCounters) ? counterNames[counter] : "";
+}
+
+const char *ClockMetrics::getHistogramName(uint8_t histogram)
+{
+    return (histogram < numberOfHistograms) ? histogramNames[histogram] : "";
+}
+
+void ClockMetrics::reset()
+{
+    for (uint8_t i = 0; i < numberOfCounters; i++) {
+        atomic_set(&counters[i], 0);
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    memset(histograms, 0, sizeof(histograms));
+    hourWakeups = 0;
+
+    k_spin_unlock(&lock, key);
+
+    LOG_INF("The metrics were cleared");
+}
+
+#ifdef CONFIG_APP_METRICS
+/**
+ * Counts every I2C transaction of the RTC driver, it replaces the empty default of the driver
+ */
+void rtc_i2c_transaction(const struct device *dev)
+{
+    ClockMetrics::count(ClockMetrics::counterI2cRtc);
+}
+
+/**
+ * Counts every I2C transaction of the light sensor driver, it replaces the empty default of the driver
+ */
+void veml7700_i2c_transaction(const struct device *dev)
+{
+    ClockMetrics::count(ClockMetrics::counterI2cLightSensor);
+}
+#endif
+
+#if defined(CONFIG_SHELL) && defined(CONFIG_APP_METRICS)
+/**
+ * Prints all the counters and the histograms
+ */
+static int metricsShow(const struct shell *sh, size_t argc, char **argv)
+{
+    shell_print(sh, "uptime: %u s", k_uptime_get_32() / MSEC_PER_SEC);
+
+    for (uint8_t i = 0; i < ClockMetrics::numberOfCounters; i++) {
+        shell_print(sh, "%-18s %u", ClockMetrics::getCounterName(i), ClockMetrics::getCounter(i));
+    }
+
+    for (uint8_t i = 0; i < ClockMetrics::numberOfHistograms; i++) {
+        ClockMetricsHistogram histogram = ClockMetrics::getHistogram(i);
+
+        if (histogram.count == 0) {
+            shell_print(sh, "%-18s no values", ClockMetrics::getHistogramName(i));
+            continue;
+        }
+
+        shell_print(sh, "%-18s count: %u, min: %u, avg: %u, max: %u", ClockMetrics::getHistogramName(i),
+            histogram.count, histogram.minimum, (uint32_t)(histogram.sum / histogram.count), histogram.maximum);
+    }
+
+    return 0;
+}
+
+/**
+ * Clears all the counters and the histograms
+ */
+static int metricsReset(const struct shell *sh, size_t argc, char **argv)
+{
+    ClockMetrics::reset();
+
+    shell_print(sh, "The metrics were cleared");
+
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(metricsCommands,
+    SHELL_CMD(show, NULL, "Print the counters and the histograms", metricsShow),
+    SHELL_CMD(reset, NULL, "Clear the counters and the histograms", metricsReset),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(metrics, &metricsCommands, "Clock runtime metrics", metricsShow);
+#endif
@@ -1,20 +1,57 @@
 #include <ClockSettings.h>
 
+LOG_MODULE_REGISTER(clock_settings, CONFIG_APP_SETTINGS_LOG_LEVEL);
+
+//the record slot must hold whole EEPROM pages
+BUILD_ASSERT((ClockSettingsLog::slotSize % DT_PROP(DT_COMPAT_GET_ANY_STATUS_OKAY(atmel_at24), pagesize)) == 0);
+BUILD_ASSERT(sizeof(ClockSettingsRecordV1) <= ClockSettingsLog::maxPayloadSize);
+BUILD_ASSERT(sizeof(ClockSettingsRecord) <= ClockSettingsLog::maxPayloadSize);
+
+//the old whole-record log took the whole EEPROM
+ClockSettingsLog ClockSettings::settingsLog(DEVICE_DT_GET(DT_COMPAT_GET_ANY_STATUS_OKAY(atmel_at24)), 0,
+    DT_PROP(DT_COMPAT_GET_ANY_STATUS_OKAY(atmel_at24), size), ClockSettings::settingsLogMagic);
+
+const char ClockSettings::settingsRoot[] = "clock";
+
+const ClockSettings::Key ClockSettings::keys[] = {
+    {keyDst, "clock/dst", offsetof(ClockSettingsRecord, dstRule), sizeof(ClockSettingsRuleRecord)},
+    {keyStd, "clock/std", offsetof(ClockSettingsRecord, stdRule), sizeof(ClockSettingsRuleRecord)},
+    {keyAlarm, "clock/alarm", offsetof(ClockSettingsRecord, hourlyAlarm), sizeof(uint8_t)},
+    //both formats are stored together
+    {keyFormat, "clock/format", offsetof(ClockSettingsRecord, formatTemperature), 2 * sizeof(uint8_t)},
+};
+
+ClockSettings *ClockSettings::instance = NULL;
+
+struct settings_handler ClockSettings::settingsHandler;
+
 ClockSettings::ClockSettings()
 {
     setDefaultValues();
 
-    load();
+    k_mutex_init(&mutexSettings);
+
+    instance = this;
+
+    //the keys are loaded on the first access
+    int ret = settings_subsys_init();
+    if (ret != 0) {
+        LOG_ERR("Error: Couldn't init the settings subsystem: err: %d", ret);
+        return;
+    }
+
+    settingsHandler.name = (char *)settingsRoot;
+    settingsHandler.h_set = settingsSet;
 
-    readFormat();
+    ret = settings_register(&settingsHandler);
+    if (ret != 0) {
+        LOG_ERR("Error: Couldn't register the settings handler: err: %d", ret);
+    }
 }
 
 void ClockSettings::setDefaultValues()
 {
-    printk("Setting the default values\n");
-
-    //settings ID that verifies the data was loaded correctly
-    this->settingsId = 0x4322;
+    LOG_DBG("Setting the default values");
 
     TimeChangeRule dstRule = {"PDT", Second, Sun, Mar, 2, -420};
     this->dstRule = dstRule;
@@ -32,148 +69,464 @@ void ClockSettings::setDefaultValues()
 
 const struct device *ClockSettings::getEepromDevice()
 {
-    printk("Init Device EEPROM.\n");
+    LOG_DBG("Init Device EEPROM");
 
     //const struct device *eeprom = device_get_binding(DT_LABEL(DT_INST(0, atmel_at24)));
     const struct device *eeprom = DEVICE_DT_GET(DT_COMPAT_GET_ANY_STATUS_OKAY(atmel_at24));
     
     if (!device_is_ready(eeprom)) {
-        printk("Device EEPROM not found.\n");
+        LOG_ERR("Device EEPROM not found");
         return NULL;
     }
 
-        printk("Device EEPROM was initialized.\n");
+        LOG_DBG("Device EEPROM was initialized");
 
     return eeprom;
 }
 
+const ClockSettings::Key *ClockSettings::findKey(uint8_t keyId)
+{
+    for (uint8_t i = 0; i < sizeof(keys)/sizeof(keys[0]); i++) {
+        if (keys[i].id == keyId) {
+            return &keys[i];
+        }
+    }
+
+    return NULL;
+}
+
 int ClockSettings::load()
 {
-    const struct device *eeprom = getEepromDevice();
+    for (uint8_t i = 0; i < sizeof(keys)/sizeof(keys[0]); i++) {
+        ensureLoaded(keys[i].id);
+    }
 
-    if (eeprom == NULL) {
-        return 1;
+    return 0;
+}
+
+void ClockSettings::ensureLoaded(uint8_t keyId)
+{
+    //the key is marked as loaded only after its load, so no thread reads its default value
+    if (atomic_get(&loadedKeys) & keyId) {
+        return;
     }
 
-    int ret = eeprom_read(eeprom, 0, (void *)this, sizeof(*this));
-    if (ret < 0) {
-        printk("Error: Couldn't read eeprom: err: %d.\n", ret);
-        return 1;
+    k_mutex_lock(&mutexSettings, K_FOREVER);
+
+    //another thread loaded it while this one waited, or the migration of this key came back to it
+    if ((atomic_get(&loadedKeys) & keyId) || (loadingKeys & keyId)) {
+        k_mutex_unlock(&mutexSettings);
+        return;
     }
 
-    printk("settingsId: %zu\n", this->settingsId);
+    loadingKeys |= keyId;
 
-    printk("The config was read from EEPROM\n");    
+    const Key *key = findKey(keyId);
+
+    //only the region of this key is read
+    int ret = settings_load_subtree(key->name);
+    if (ret != 0) {
+        LOG_ERR("Error: Couldn't load the settings key %s: err: %d", key->name, ret);
+    }
 
-    //the settings ID doesn't match, load the default values
-    if (this->settingsId != 0x4322) {
-        setDefaultValues();
+    //the key was never saved, take it from the old whole record
+    if (!(committedKeys & keyId)) {
+        migrateKey(key);
     }
 
+    //the format pins override the saved format
+    if (keyId == keyFormat) {
+        readFormat();
+    }
+
+    loadingKeys &= ~keyId;
+    atomic_or(&loadedKeys, keyId);
+
+    k_mutex_unlock(&mutexSettings);
+}
+
+int ClockSettings::settingsSet(const char *name, size_t length, settings_read_cb readCb, void *cbArg)
+{
+    uint8_t value[sizeof(ClockSettingsRecord)];
+
+    if (instance == NULL) {
+        return -ENOENT;
+    }
+
+    for (uint8_t i = 0; i < sizeof(keys)/sizeof(keys[0]); i++) {
+        //the name comes without the "clock/" prefix
+        if (strcmp(keys[i].name + sizeof(settingsRoot), name) != 0) {
+            continue;
+        }
+
+        if (length != keys[i].size) {
+            LOG_WRN("The settings key %s has a wrong length %u", keys[i].name, length);
+            return -EINVAL;
+        }
+
+        ssize_t ret = readCb(cbArg, value, length);
+        if (ret != (ssize_t)length) {
+            return -EIO;
+        }
+
+        return instance->applyKeyValue(&keys[i], value, length);
+    }
+
+    return -ENOENT;
+}
+
+int ClockSettings::applyKeyValue(const Key *key, const void *value, size_t length)
+{
+    ClockSettingsRecord record;
+
+    //check the new value together with the other current values
+    toRecord(&record);
+    memcpy((uint8_t *)&record + key->offset, value, length);
+
+    if (!isValidRecord(&record)) {
+        LOG_WRN("The settings key %s is not valid, using the default value", key->name);
+        return -EINVAL;
+    }
+
+    fromRecord(&record);
+
+    memcpy((uint8_t *)&committedRecord + key->offset, value, length);
+    committedKeys |= key->id;
+
+    LOG_DBG("The settings key %s was loaded", key->name);
+
     return 0;
 }
 
-int ClockSettings::save()
+void ClockSettings::migrateKey(const Key *key)
 {
-    const struct device *eeprom = getEepromDevice();
+    ClockSettingsRecord record;
 
-    //write all variables of the settings class to the EEPROM
-    //const char *p = (const char*)(const void*)this;
+    if (legacyState == legacyUnknown) {
+        legacyState = ((loadLegacyRecord(&legacyRecord) == 0) && isValidRecord(&legacyRecord))
+            ? legacyPresent : legacyAbsent;
+    }
+
+    if (legacyState != legacyPresent) {
+        return;
+    }
+
+    //the first saved key may overwrite the old record, so the other keys are migrated now too
+    for (uint8_t i = 0; i < sizeof(keys)/sizeof(keys[0]); i++) {
+        if (!(atomic_get(&loadedKeys) & keys[i].id)) {
+            ensureLoaded(keys[i].id);
+        }
+    }
+
+    toRecord(&record);
+    memcpy((uint8_t *)&record + key->offset, (const uint8_t *)&legacyRecord + key->offset, key->size);
+    fromRecord(&record);
+
+    LOG_DBG("Migrating the settings key %s", key->name);
+
+    saveKey(key, &record);
+}
+
+int ClockSettings::loadLegacyRecord(ClockSettingsRecord *record)
+{
+    const struct device *eeprom = getEepromDevice();
+    uint8_t buffer[ClockSettingsLog::maxPayloadSize];
+    uint8_t version = 0;
 
     if (eeprom == NULL) {
         return 1;
     }
 
-    int ret = eeprom_write(eeprom, 0, (const void*)this, sizeof(*this));
+    int ret = settingsLog.read(&version, buffer, sizeof(buffer));
+
+    if (ret == -ENOENT) {
+        //the log is empty, the settings may be left at the address 0 by the old firmware
+        return loadLegacy(eeprom, record);
+    }
+
+    if ((version == settingsVersion1) && (ret == sizeof(ClockSettingsRecordV1))) {
+        ClockSettingsRecordV1 recordV1;
+        memcpy(&recordV1, buffer, sizeof(recordV1));
+        return migrateV1(&recordV1, record) ? 0 : 1;
+    }
+
+    if ((version == settingsVersion2) && (ret == sizeof(ClockSettingsRecord))) {
+        memcpy(record, buffer, sizeof(*record));
+        return 0;
+    }
+
+    LOG_DBG("No old settings record: err: %d, version: %u", ret, version);
+
+    return 1;
+}
+
+int ClockSettings::loadLegacy(const struct device *eeprom, ClockSettingsRecord *record)
+{
+    ClockSettingsRecordV1 recordV1;
+
+    ClockMetrics::count(ClockMetrics::counterI2cEeprom);
+
+    int ret = eeprom_read(eeprom, 0, &recordV1, sizeof(recordV1));
     if (ret < 0) {
-        printk("Error: Couldn't write eeprom: err:%d.\n", ret);
+        LOG_ERR("Error: Couldn't read eeprom: err: %d", ret);
         return 1;
     }
 
-    printk("Wrote the settings object into the EEPROM.\n");
+    if (!migrateV1(&recordV1, record)) {
+        return 1;
+    }
+
+    return 0;
+}
+
+bool ClockSettings::migrateV1(const ClockSettingsRecordV1 *recordV1, ClockSettingsRecord *record)
+{
+    LOG_DBG("settingsId: %u", recordV1->settingsId);
+
+    //the settings ID doesn't match, the data is not a settings object
+    if (recordV1->settingsId != settingsIdV1) {
+        return false;
+    }
+
+    toRuleRecord(&recordV1->dstRule, &record->dstRule);
+    toRuleRecord(&recordV1->stdRule, &record->stdRule);
+
+    record->hourlyAlarm = recordV1->hourlyAlarm ? 1 : 0;
+    record->formatTemperature = recordV1->formatTemperature;
+    record->formatHour = recordV1->formatHour;
+
+    return true;
+}
+
+bool ClockSettings::isValidRecord(const ClockSettingsRecord *record)
+{
+    const ClockSettingsRuleRecord *rules[] = {&record->dstRule, &record->stdRule};
+
+    for (uint8_t i = 0; i < sizeof(rules)/sizeof(rules[0]); i++) {
+        //the offsets are from -12:00 to +14:00
+        if ((rules[i]->week > Fourth) || (rules[i]->dow > Sat) || (rules[i]->month > Dec)
+            || (rules[i]->hour > 23) || (rules[i]->offset < -12 * 60) || (rules[i]->offset > 14 * 60)) {
+            return false;
+        }
+    }
+
+    if (record->hourlyAlarm > 1) {
+        return false;
+    }
+
+    if ((record->formatTemperature != formatCelsius) && (record->formatTemperature != formatFahrenheit)) {
+        return false;
+    }
+
+    if ((record->formatHour != formatHour12) && (record->formatHour != formatHour24)) {
+        return false;
+    }
+
+    return true;
+}
+
+void ClockSettings::toRuleRecord(const TimeChangeRule *rule, ClockSettingsRuleRecord *ruleRecord)
+{
+    memcpy(ruleRecord->abbrev, rule->abbrev, sizeof(ruleRecord->abbrev));
+    ruleRecord->abbrev[sizeof(ruleRecord->abbrev) - 1] = '\0';
+    ruleRecord->week = rule->week;
+    ruleRecord->dow = rule->dow;
+    ruleRecord->month = rule->month;
+    ruleRecord->hour = rule->hour;
+    ruleRecord->offset = rule->offset;
+}
+
+void ClockSettings::fromRuleRecord(const ClockSettingsRuleRecord *ruleRecord, TimeChangeRule *rule)
+{
+    memcpy(rule->abbrev, ruleRecord->abbrev, sizeof(rule->abbrev));
+    rule->abbrev[sizeof(rule->abbrev) - 1] = '\0';
+    rule->week = ruleRecord->week;
+    rule->dow = ruleRecord->dow;
+    rule->month = ruleRecord->month;
+    rule->hour = ruleRecord->hour;
+    rule->offset = ruleRecord->offset;
+}
+
+void ClockSettings::fromRecord(const ClockSettingsRecord *record)
+{
+    fromRuleRecord(&record->dstRule, &dstRule);
+    fromRuleRecord(&record->stdRule, &stdRule);
+
+    hourlyAlarm = (record->hourlyAlarm != 0);
+    formatTemperature = record->formatTemperature;
+    formatHour = record->formatHour;
+}
+
+void ClockSettings::toRecord(ClockSettingsRecord *record)
+{
+    //the unused bytes of the abbreviations are stored as zeros
+    memset(record, 0, sizeof(*record));
+
+    toRuleRecord(&dstRule, &record->dstRule);
+    toRuleRecord(&stdRule, &record->stdRule);
+
+    record->hourlyAlarm = hourlyAlarm ? 1 : 0;
+    record->formatTemperature = formatTemperature;
+    record->formatHour = formatHour;
+}
+
+int ClockSettings::saveKey(const Key *key, const ClockSettingsRecord *record)
+{
+    const uint8_t *value = (const uint8_t *)record + key->offset;
+
+    int ret = settings_save_one(key->name, value, key->size);
+    if (ret != 0) {
+        LOG_ERR("Error: Couldn't save the settings key %s: err:%d", key->name, ret);
+        return ret;
+    }
+
+    memcpy((uint8_t *)&committedRecord + key->offset, value, key->size);
+    committedKeys |= key->id;
+
+    LOG_DBG("Wrote the settings key %s into the EEPROM", key->name);
 
     return 0;
 }
 
+int ClockSettings::save()
+{
+    ClockSettingsRecord record;
+    int result = 0;
+
+    k_mutex_lock(&mutexSettings, K_FOREVER);
+
+    toRecord(&record);
+
+    for (uint8_t i = 0; i < sizeof(keys)/sizeof(keys[0]); i++) {
+        const Key *key = &keys[i];
+
+        //a key that was never loaded holds the default value, it must not overwrite the stored one
+        if (!(atomic_get(&loadedKeys) & key->id)) {
+            continue;
+        }
+
+        //only the changed keys are written
+        if ((committedKeys & key->id) && (memcmp((const uint8_t *)&record + key->offset,
+            (const uint8_t *)&committedRecord + key->offset, key->size) == 0)) {
+            continue;
+        }
+
+        //the other keys are still saved, the last error is returned
+        int ret = saveKey(key, &record);
+        if (ret != 0) {
+            result = ret;
+        }
+    }
+
+    k_mutex_unlock(&mutexSettings);
+
+    return result;
+}
+
 void ClockSettings::readFormat()
 {
     int ret = 0;
 
-    printk("Settings readFormat\n");
+    LOG_DBG("Settings readFormat");
+
+    //the pin order sets the priority, the last set pin wins
+    const struct gpio_dt_spec formatPins[numberOfFormatPins] = {
+        GPIO_DT_SPEC_GET(DT_PATH(bmw_clock), celsius12_gpios),
+        GPIO_DT_SPEC_GET(DT_PATH(bmw_clock), celsius24_gpios),
+        GPIO_DT_SPEC_GET(DT_PATH(bmw_clock), fahrenheit12_gpios),
+    };
+    uint8_t levels[numberOfFormatPins];
 
-    //first set HIGH to the enable format pin
+    //configure all the format pins before the enable-format pin, so they settle together
+    for (uint8_t i = 0; i < numberOfFormatPins; i++) {
+        configureFormatPin(&formatPins[i]);
+    }
+
+    //set HIGH to the enable format pin
     const struct gpio_dt_spec enableFormat = GPIO_DT_SPEC_GET(DT_PATH(bmw_clock), enable_format_gpios);
 
     if (!device_is_ready(enableFormat.port)) {
-        printk("Error: GPIO enableFormat %s is not ready\n", enableFormat.port->name);
+        LOG_ERR("Error: GPIO enableFormat %s is not ready", enableFormat.port->name);
     } else {    
         //active when the level is high
         ret = gpio_pin_configure_dt(&enableFormat, GPIO_OUTPUT_HIGH);
         if (ret != 0) {
-            printk("Error %d: failed to configure %s pin %d\n",
+            LOG_ERR("Error %d: failed to configure %s pin %d",
                 ret, enableFormat.port->name, enableFormat.pin);
         }
     }
 
-    ret = gpio_pin_set_dt(&enableFormat, 1);
+    //a single settle time for all the pins
+    k_msleep(formatSettleTime);
+
+    readFormatPins(formatPins, levels);
+
+    //disable the high level on the enable-format pin
+    ret = gpio_pin_set_dt(&enableFormat, 0);
     if (ret != 0) {
-        printk("Error %d: pin set enableFormat %s pin %d\n",
+        LOG_ERR("Error %d: pin set enableFormat %s pin %d",
             ret, enableFormat.port->name, enableFormat.pin);
     }
 
-    k_msleep(10);
+    ret = gpio_pin_configure_dt(&enableFormat, GPIO_INPUT);
+
+    LOG_DBG("Format pins: celsius12: %d, celsius24: %d, fahrenheit12: %d",
+        levels[0], levels[1], levels[2]);
 
-    const struct gpio_dt_spec celsius12 = GPIO_DT_SPEC_GET(DT_PATH(bmw_clock), celsius12_gpios);
-    if (readFormatPin(&celsius12)) {
+    if (levels[0]) {
         this->formatTemperature = ClockSettings::formatCelsius;
         this->formatHour = ClockSettings::formatHour12;
     }
 
-    const struct gpio_dt_spec celsius24 = GPIO_DT_SPEC_GET(DT_PATH(bmw_clock), celsius24_gpios);
-    if (readFormatPin(&celsius24)) {
+    if (levels[1]) {
         this->formatTemperature = ClockSettings::formatCelsius;
         this->formatHour = ClockSettings::formatHour24;
     }
 
-    const struct gpio_dt_spec fahrenheit12 = GPIO_DT_SPEC_GET(DT_PATH(bmw_clock), fahrenheit12_gpios);
-    if (readFormatPin(&fahrenheit12)) {
+    if (levels[2]) {
         this->formatTemperature = ClockSettings::formatFahrenheit;
         this->formatHour = ClockSettings::formatHour12;
     }
+}
 
-    //disable the high level on the enable-format pin
-    ret = gpio_pin_set_dt(&enableFormat, 0);
-    if (ret != 0) {
-        printk("Error %d: pin set enableFormat %s pin %d\n",
-            ret, enableFormat.port->name, enableFormat.pin);
+void ClockSettings::configureFormatPin(const struct gpio_dt_spec *gpio)
+{
+    if (!device_is_ready(gpio->port)) {
+        LOG_ERR("Error: GPIO %s is not ready", gpio->port->name);
+        return;
     }
 
-    ret = gpio_pin_configure_dt(&enableFormat, GPIO_INPUT);
+    int ret = gpio_pin_configure_dt(gpio, GPIO_INPUT | GPIO_PULL_DOWN | GPIO_ACTIVE_HIGH);
+    if (ret != 0) {
+        LOG_ERR("Error %d: failed to configure %s pin %d",
+            ret, gpio->port->name, gpio->pin);
+    }
 }
 
-uint8_t ClockSettings::readFormatPin(const struct gpio_dt_spec *gpio)
+void ClockSettings::readFormatPins(const struct gpio_dt_spec *gpios, uint8_t *levels)
 {
-    int ret = 0;
-    int level = 0;
+    gpio_port_value_t values[numberOfFormatPins];
+    int results[numberOfFormatPins];
 
-    printk("Configure %s pin %d\n",
-                 gpio->port->name, gpio->pin);
+    for (uint8_t i = 0; i < numberOfFormatPins; i++) {
+        uint8_t j = 0;
 
-    if (!device_is_ready(gpio->port)) {
-        printk("Error: GPIO %s is not ready\n", gpio->port->name);
-    } else {    
-        ret = gpio_pin_configure_dt(gpio, GPIO_INPUT | GPIO_PULL_DOWN | GPIO_ACTIVE_HIGH);
-        if (ret != 0) {
-            printk("Error %d: failed to configure %s pin %d\n",
-                ret, gpio->port->name, gpio->pin);
+        //the pins on the same port share one read
+        while ((j < i) && (gpios[j].port != gpios[i].port)) {
+            j++;
         }
 
-        k_msleep(10);
+        if (j == i) {
+            values[i] = 0;
+            results[i] = device_is_ready(gpios[i].port) ? gpio_port_get(gpios[i].port, &values[i]) : -ENODEV;
+            if (results[i] != 0) {
+                LOG_ERR("Error %d: failed to read the port %s", results[i], gpios[i].port->name);
+            }
+        } else {
+            values[i] = values[j];
+            results[i] = results[j];
+        }
 
-        level = gpio_pin_get_dt(gpio);
-        printk("\nLevel: %d\n", level);
+        levels[i] = ((results[i] == 0) && (values[i] & BIT(gpios[i].pin))) ? 1 : 0;
     }
-
-    return level;
 }
-
@@ -0,0 +1,185 @@
+#include <ClockSettingsLog.h>
+
+LOG_MODULE_REGISTER(clock_settings_log, CONFIG_APP_SETTINGS_LOG_LEVEL);
+
+int ClockSettingsLog::readHeader(uint32_t slot, ClockSettingsLogHeader *header)
+{
+    ClockMetrics::count(ClockMetrics::counterI2cEeprom);
+
+    int ret = eeprom_read(eeprom, getSlotAddress(slot), header, sizeof(*header));
+    if (ret < 0) {
+        LOG_ERR("Error: Couldn't read the settings log header %u: err: %d", slot, ret);
+        return ret;
+    }
+
+    return 0;
+}
+
+bool ClockSettingsLog::isInCurrentPass(uint32_t slot, uint32_t firstSequence)
+{
+    ClockSettingsLogHeader header;
+
+    if (readHeader(slot, &header) != 0) {
+        return false;
+    }
+
+    return ((header.magic == magic) && (header.sequence == (firstSequence + slot)));
+}
+
+int ClockSettingsLog::scan()
+{
+    ClockSettingsLogHeader header;
+
+    if ((eeprom == NULL) || (numberOfSlots == 0)) {
+        return -ENODEV;
+    }
+
+    int ret = readHeader(0, &header);
+    if (ret != 0) {
+        return ret;
+    }
+
+    scanned = true;
+
+    //the slot 0 is written first, so the log is empty
+    if (header.magic != magic) {
+        LOG_DBG("The settings log is empty");
+        headSlot = -1;
+        headSequence = 0;
+        return 0;
+    }
+
+    //the slots written after the slot 0 have the next sequence numbers,
+    //the rest of the slots are left from the previous pass or empty
+    uint32_t low = 0;
+    uint32_t high = numberOfSlots - 1;
+
+    while (low < high) {
+        uint32_t middle = (low + high + 1) / 2;
+
+        if (isInCurrentPass(middle, header.sequence)) {
+            low = middle;
+        } else {
+            high = middle - 1;
+        }
+    }
+
+    headSlot = low;
+    headSequence = header.sequence + low;
+
+    LOG_DBG("The settings log head slot: %d, sequence: %u", headSlot, headSequence);
+
+    return 0;
+}
+
+uint16_t ClockSettingsLog::calculateCrc(const ClockSettingsLogHeader *header, const void *payload)
+{
+    //the magic is not protected, it only marks the slot as written
+    uint16_t crc = crc16_ccitt(0xffff, (const uint8_t *)&header->version,
+        sizeof(*header) - sizeof(header->magic));
+
+    return crc16_ccitt(crc, (const uint8_t *)payload, header->length);
+}
+
+int ClockSettingsLog::read(uint8_t *version, void *payload, uint8_t maxLength)
+{
+    uint8_t buffer[maxPayloadSize + sizeof(uint16_t)];
+    ClockSettingsLogHeader header;
+
+    if (!scanned) {
+        int ret = scan();
+        if (ret != 0) {
+            return ret;
+        }
+    }
+
+    if (headSlot < 0) {
+        return -ENOENT;
+    }
+
+    //the newest record may be broken, then try the older ones
+    uint32_t slot = headSlot;
+    for (uint8_t i = 0; (i < maxFallbackSlots) && (i < numberOfSlots); i++) {
+        if ((readHeader(slot, &header) == 0) && (header.magic == magic)
+            && (header.length <= maxPayloadSize)) {
+            int ret = eeprom_read(eeprom, getSlotAddress(slot) + sizeof(header), buffer,
+                header.length + sizeof(uint16_t));
+            ClockMetrics::count(ClockMetrics::counterI2cEeprom);
+
+            uint16_t crc = buffer[header.length] | (buffer[header.length + 1] << 8);
+
+            if ((ret == 0) && (crc == calculateCrc(&header, buffer)) && (header.length <= maxLength)) {
+                memcpy(payload, buffer, header.length);
+                *version = header.version;
+
+                LOG_DBG("Read the settings record from the slot %u, sequence: %u", slot, header.sequence);
+
+                return header.length;
+            }
+        }
+
+        LOG_WRN("The settings record in the slot %u is broken", slot);
+
+        slot = (slot == 0) ? (numberOfSlots - 1) : (slot - 1);
+    }
+
+    return -EIO;
+}
+
+int ClockSettingsLog::append(uint8_t version, const void *payload, uint8_t length)
+{
+    uint8_t buffer[maxPayloadSize + sizeof(uint16_t)];
+
+    if (length > maxPayloadSize) {
+        return -EINVAL;
+    }
+
+    if (!scanned) {
+        int ret = scan();
+        if (ret != 0) {
+            return ret;
+        }
+    }
+
+    uint32_t slot = (headSlot < 0) ? 0 : ((headSlot + 1) % numberOfSlots);
+
+    ClockSettingsLogHeader header = {
+        .magic = magic,
+        .version = version,
+        .length = length,
+        .sequence = (headSlot < 0) ? 0 : (headSequence + 1),
+    };
+
+    uint16_t crc = calculateCrc(&header, payload);
+
+    memcpy(buffer, payload, length);
+    buffer[length] = crc & 0xff;
+    buffer[length + 1] = crc >> 8;
+
+    uint32_t start = ClockMetrics::startTimer();
+
+    //the payload goes first, the header makes the record valid only after the payload is complete
+    int ret = eeprom_write(eeprom, getSlotAddress(slot) + sizeof(header), buffer, length + sizeof(uint16_t));
+    ClockMetrics::count(ClockMetrics::counterI2cEeprom);
+    if (ret < 0) {
+        LOG_ERR("Error: Couldn't write the settings record: err:%d", ret);
+        return ret;
+    }
+
+    ret = eeprom_write(eeprom, getSlotAddress(slot), &header, sizeof(header));
+    ClockMetrics::count(ClockMetrics::counterI2cEeprom);
+    if (ret < 0) {
+        LOG_ERR("Error: Couldn't write the settings record header: err:%d", ret);
+        return ret;
+    }
+
+    headSlot = slot;
+    headSequence = header.sequence;
+
+    ClockMetrics::recordTime(ClockMetrics::histogramEepromWriteTime, start);
+    ClockMetrics::count(ClockMetrics::counterEepromWrites);
+
+    LOG_DBG("Wrote the settings record into the slot %u, sequence: %u", slot, header.sequence);
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include <ClockSettingsStorage.h>
+
+LOG_MODULE_REGISTER(clock_settings_storage, CONFIG_APP_SETTINGS_LOG_LEVEL);
+
+#define CLOCK_SETTINGS_EEPROM DT_COMPAT_GET_ANY_STATUS_OKAY(atmel_at24)
+
+//the EEPROM is split into equal regions, one for each key
+#define CLOCK_SETTINGS_REGION_SIZE (DT_PROP(CLOCK_SETTINGS_EEPROM, size) / 4)
+
+#define CLOCK_SETTINGS_KEY(keyName, region) \
+    {keyName, ClockSettingsLog(DEVICE_DT_GET(CLOCK_SETTINGS_EEPROM), \
+        (region) * CLOCK_SETTINGS_REGION_SIZE, CLOCK_SETTINGS_REGION_SIZE, keyLogMagic)}
+
+ClockSettingsStorageKey ClockSettingsStorage::keys[] = {
+    CLOCK_SETTINGS_KEY("clock/dst", 0),
+    CLOCK_SETTINGS_KEY("clock/std", 1),
+    CLOCK_SETTINGS_KEY("clock/alarm", 2),
+    CLOCK_SETTINGS_KEY("clock/format", 3),
+};
+
+const uint8_t ClockSettingsStorage::numberOfKeys = sizeof(keys)/sizeof(keys[0]);
+
+struct settings_store ClockSettingsStorage::store;
+
+const struct settings_store_itf ClockSettingsStorage::storeInterface = {
+    .csi_load = ClockSettingsStorage::load,
+    .csi_save_start = NULL,
+    .csi_save = ClockSettingsStorage::save,
+    .csi_save_end = NULL,
+    .csi_storage_get = NULL,
+};
+
+/**
+ * The settings subsystem calls it from settings_subsys_init() when CONFIG_SETTINGS_CUSTOM is set
+ */
+extern "C" int settings_backend_init(void)
+{
+    return ClockSettingsStorage::init();
+}
+
+int ClockSettingsStorage::init()
+{
+    const struct device *eeprom = DEVICE_DT_GET(CLOCK_SETTINGS_EEPROM);
+
+    if (!device_is_ready(eeprom)) {
+        LOG_ERR("Device EEPROM for the settings not found");
+        return -ENODEV;
+    }
+
+    store.cs_itf = &storeInterface;
+
+    settings_src_register(&store);
+    settings_dst_register(&store);
+
+    LOG_INF("The settings storage was registered");
+
+    return 0;
+}
+
+ClockSettingsStorageKey *ClockSettingsStorage::findKey(const char *name)
+{
+    for (uint8_t i = 0; i < numberOfKeys; i++) {
+        if (strcmp(keys[i].name, name) == 0) {
+            return &keys[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * The value that is passed to the settings handler
+ */
+struct ClockSettingsStorageValue {
+    const uint8_t *data;
+    size_t length;
+};
+
+ssize_t ClockSettingsStorage::readValue(void *cbArg, void *data, size_t length)
+{
+    const ClockSettingsStorageValue *value = (const ClockSettingsStorageValue *)cbArg;
+
+    length = MIN(length, value->length);
+    memcpy(data, value->data, length);
+
+    return length;
+}
+
+int ClockSettingsStorage::load(struct settings_store *cs, const struct settings_load_arg *arg)
+{
+    uint8_t buffer[ClockSettingsLog::maxPayloadSize];
+    uint8_t version = 0;
+
+    for (uint8_t i = 0; i < numberOfKeys; i++) {
+        //only the keys inside the requested subtree are read
+        if ((arg != NULL) && (arg->subtree != NULL) && !settings_name_steq(keys[i].name, arg->subtree, NULL)) {
+            continue;
+        }
+
+        int ret = keys[i].log.read(&version, buffer, sizeof(buffer));
+        if (ret == -ENOENT) {
+            continue;
+        }
+
+        //a zero length value is a deleted key
+        if ((ret <= 0) || (version != valueVersion)) {
+            LOG_WRN("The settings key %s is not loaded: err: %d, version: %u", keys[i].name, ret, version);
+            continue;
+        }
+
+        ClockSettingsStorageValue value = {buffer, (size_t)ret};
+
+        settings_call_set_handler(keys[i].name, ret, readValue, &value, arg);
+    }
+
+    return 0;
+}
+
+int ClockSettingsStorage::save(struct settings_store *cs, const char *name, const char *value, size_t valueLength)
+{
+    ClockSettingsStorageKey *key = findKey(name);
+
+    if (key == NULL) {
+        LOG_WRN("The settings key %s has no storage", name);
+        return -ENOENT;
+    }
+
+    if (valueLength > ClockSettingsLog::maxPayloadSize) {
+        return -EINVAL;
+    }
+
+    //a deleted key is written as an empty value
+    return key->log.append(valueVersion, (value != NULL) ? value : "", (value != NULL) ? valueLength : 0);
+}
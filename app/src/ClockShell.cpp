@@ -0,0 +1,387 @@
+#include <ClockShell.h>
+
+LOG_MODULE_REGISTER(clock_shell, CONFIG_APP_LOG_LEVEL);
+
+ClockSettings *ClockShell::clockSettings = NULL;
+
+ClockTime *ClockShell::clockTime = NULL;
+
+ClockDisplay *ClockShell::clockDisplay = NULL;
+
+void ClockShell::init(ClockSettings *clockSettings, ClockTime *clockTime, ClockDisplay *clockDisplay)
+{
+    if (!IS_ENABLED(CONFIG_APP_SHELL)) {
+        return;
+    }
+
+    ClockShell::clockSettings = clockSettings;
+    ClockShell::clockTime = clockTime;
+    ClockShell::clockDisplay = clockDisplay;
+
+    LOG_DBG("The clock shell commands are ready");
+}
+
+#ifdef CONFIG_APP_SHELL
+bool ClockShell::isReady(const struct shell *sh)
+{
+    if ((clockSettings == NULL) || (clockTime == NULL) || (clockDisplay == NULL)) {
+        shell_error(sh, "The clock is not started yet");
+        return false;
+    }
+
+    return true;
+}
+
+uint8_t ClockShell::parseNumbers(const char *str, char separator, long *numbers, uint8_t maxNumbers)
+{
+    uint8_t parsed = 0;
+
+    while (parsed < maxNumbers) {
+        char *end;
+
+        numbers[parsed] = strtol(str, &end, 10);
+        if (end == str) {
+            return 0;
+        }
+
+        parsed++;
+
+        if (*end == '\0') {
+            return parsed;
+        }
+
+        if (*end != separator) {
+            return 0;
+        }
+
+        str = end + 1;
+    }
+
+    //there are more numbers than expected
+    return 0;
+}
+
+bool ClockShell::parseNumber(const struct shell *sh, const char *str, long minimum, long maximum, long *number)
+{
+    if ((parseNumbers(str, '\0', number, 1) != 1) || (*number < minimum) || (*number > maximum)) {
+        shell_error(sh, "Wrong value %s, it must be from %ld to %ld", str, minimum, maximum);
+        return false;
+    }
+
+    return true;
+}
+
+int ClockShell::timeCommand(const struct shell *sh, size_t argc, char **argv)
+{
+    if (!isReady(sh)) {
+        return -EAGAIN;
+    }
+
+    clockTime->getRtcTime();
+
+    if (argc > 1) {
+        //hh:mm or hh:mm:ss, the seconds are 0 if they are not given
+        long time[3] = {0, 0, 0};
+        uint8_t parsed = parseNumbers(argv[1], ':', time, 3);
+
+        if ((parsed < 2) || (time[0] < 0) || (time[0] > 23) || (time[1] < 0) || (time[1] > 59)
+            || (time[2] < 0) || (time[2] > 59)) {
+            shell_error(sh, "Wrong time %s, it must be hh:mm or hh:mm:ss", argv[1]);
+            return -EINVAL;
+        }
+
+        //the date stays if it is not given
+        long date[3] = {clockTime->getYear(), clockTime->getMonth(), clockTime->getDay()};
+
+        if ((argc > 2) && ((parseNumbers(argv[2], '-', date, 3) != 3) || (date[0] < 2021) || (date[0] > 2099)
+            || (date[1] < 1) || (date[1] > 12) || (date[2] < 1))) {
+            shell_error(sh, "Wrong date %s, it must be yyyy-mm-dd from 2021 to 2099", argv[2]);
+            return -EINVAL;
+        }
+
+        clockTime->setYear(date[0]);
+        clockTime->setMonth(date[1]);
+
+        if (date[2] > clockTime->getDaysInMonth()) {
+            shell_error(sh, "Wrong day %ld, the month has %u days", date[2], clockTime->getDaysInMonth());
+            clockTime->getRtcTime();
+            return -EINVAL;
+        }
+
+        clockTime->setDay(date[2]);
+        clockTime->setHour(time[0]);
+        clockTime->setMinute(time[1]);
+        clockTime->setSecond(time[2]);
+
+        //the date and the time are written at once
+        clockTime->setRtcTime();
+        clockTime->getRtcTime();
+
+        clockDisplay->wakeup();
+
+        LOG_INF("The time was set from the shell");
+    }
+
+    shell_print(sh, "%04u-%02u-%02u %02u:%02u:%02u %s", clockTime->getYear(), clockTime->getMonth(),
+        clockTime->getDay(), clockTime->getHour(), clockTime->getMinute(), clockTime->getSecond(),
+        clockTime->getWeekdayName());
+
+    return 0;
+}
+
+void ClockShell::printRule(const struct shell *sh, const char *name, bool dst)
+{
+    ClockTimezone *timezone = clockTime->getTimezone();
+
+    if (dst) {
+        shell_print(sh, "%s: %s %s of %s at %02u:00, offset %d min", name, timezone->getDstWeekName(),
+            timezone->getDstWeekdayName(), timezone->getDstMonthName(), timezone->getDstHour(),
+            timezone->getDstOffset());
+    } else {
+        shell_print(sh, "%s: %s %s of %s at %02u:00, offset %d min", name, timezone->getStdWeekName(),
+            timezone->getStdWeekdayName(), timezone->getStdMonthName(), timezone->getStdHour(),
+            timezone->getStdOffset());
+    }
+}
+
+int ClockShell::setRule(const struct shell *sh, char **argv, bool dst)
+{
+    long week;
+    long weekday;
+    long month;
+    long hour;
+    long offset;
+
+    //the ranges are the same as the settings record checks
+    if (!parseNumber(sh, argv[1], Last, Fourth, &week) || !parseNumber(sh, argv[2], Sun, Sat, &weekday)
+        || !parseNumber(sh, argv[3], 1, 12, &month) || !parseNumber(sh, argv[4], 0, 23, &hour)
+        || !parseNumber(sh, argv[5], -720, 840, &offset)) {
+        return -EINVAL;
+    }
+
+    //the buttons step through the offsets of the timezone, an unknown one would be shown as the first
+    if (!clockTime->getTimezone()->isOffset(offset)) {
+        shell_error(sh, "Wrong offset %ld, it is not a timezone offset", offset);
+        return -EINVAL;
+    }
+
+    //the timezone uses the rules of the settings, so they are changed together
+    if (dst) {
+        clockSettings->setDstWeek(week);
+        clockSettings->setDstWeekday(weekday);
+        clockSettings->setDstMonth(month - 1);
+        clockSettings->setDstHour(hour);
+        clockSettings->setDstOffset(offset);
+    } else {
+        clockSettings->setStdWeek(week);
+        clockSettings->setStdWeekday(weekday);
+        clockSettings->setStdMonth(month - 1);
+        clockSettings->setStdHour(hour);
+        clockSettings->setStdOffset(offset);
+    }
+
+    //only the changed rule key is written to the EEPROM
+    int ret = clockSettings->save();
+    if (ret != 0) {
+        shell_error(sh, "Cannot save the settings, err: %d", ret);
+    }
+
+    clockTime->getTimezone()->updateRules();
+    clockDisplay->wakeup();
+
+    LOG_INF("The %s rule was set from the shell", dst ? "daylight time" : "standard time");
+
+    return ret;
+}
+
+int ClockShell::dstCommand(const struct shell *sh, size_t argc, char **argv)
+{
+    if (!isReady(sh)) {
+        return -EAGAIN;
+    }
+
+    if (argc > 1) {
+        if (argc != (numberOfRuleValues + 1)) {
+            shell_error(sh, "Usage: clock dst <week 0-4> <weekday 0-6> <month 1-12> <hour> <offset min>");
+            return -EINVAL;
+        }
+
+        int ret = setRule(sh, argv, true);
+        if (ret != 0) {
+            return ret;
+        }
+    }
+
+    printRule(sh, "dst", true);
+
+    return 0;
+}
+
+int ClockShell::stdCommand(const struct shell *sh, size_t argc, char **argv)
+{
+    if (!isReady(sh)) {
+        return -EAGAIN;
+    }
+
+    if (argc > 1) {
+        if (argc != (numberOfRuleValues + 1)) {
+            shell_error(sh, "Usage: clock std <week 0-4> <weekday 0-6> <month 1-12> <hour> <offset min>");
+            return -EINVAL;
+        }
+
+        int ret = setRule(sh, argv, false);
+        if (ret != 0) {
+            return ret;
+        }
+    }
+
+    printRule(sh, "std", false);
+
+    return 0;
+}
+
+int ClockShell::alarmCommand(const struct shell *sh, size_t argc, char **argv)
+{
+    if (!isReady(sh)) {
+        return -EAGAIN;
+    }
+
+    if (argc > 1) {
+        bool hourlyAlarm;
+
+        if (strcmp(argv[1], "on") == 0) {
+            hourlyAlarm = true;
+        } else if (strcmp(argv[1], "off") == 0) {
+            hourlyAlarm = false;
+        } else {
+            shell_error(sh, "Wrong value %s, it must be on or off", argv[1]);
+            return -EINVAL;
+        }
+
+        clockSettings->setHourlyAlarm(hourlyAlarm);
+
+        int ret = clockSettings->save();
+        if (ret != 0) {
+            shell_error(sh, "Cannot save the settings, err: %d", ret);
+        }
+
+        //enable or disable hourly interrupts
+        clockTime->setAlarmInterrupt();
+    }
+
+    shell_print(sh, "hourly alarm: %s", clockSettings->getHourlyAlarm() ? "on" : "off");
+
+    return 0;
+}
+
+int ClockShell::offsetCommand(const struct shell *sh, size_t argc, char **argv)
+{
+    long offset;
+
+    if (!isReady(sh)) {
+        return -EAGAIN;
+    }
+
+    if (argc > 1) {
+        if (!parseNumber(sh, argv[1], -32, 31, &offset)) {
+            return -EINVAL;
+        }
+
+        clockTime->setCorrectionOffset(offset);
+    }
+
+    shell_print(sh, "correction offset: %+d", clockTime->getCorrectionOffset());
+
+    return 0;
+}
+
+int ClockShell::brightnessCommand(const struct shell *sh, size_t argc, char **argv)
+{
+    long level;
+
+    if (!isReady(sh)) {
+        return -EAGAIN;
+    }
+
+    if (argc > 1) {
+        if (strcmp(argv[1], "auto") == 0) {
+            clockDisplay->setBrightnessOverride(ClockDisplay::brightnessAutomatic);
+        } else if (parseNumber(sh, argv[1], 0, ClockBrightness::numberOfLevels - 1, &level)) {
+            //the display takes the level from the high 4 bits
+            clockDisplay->setBrightnessOverride(level << 4);
+        } else {
+            return -EINVAL;
+        }
+    }
+
+    int16_t brightness = clockDisplay->getBrightnessOverride();
+
+    if (brightness == ClockDisplay::brightnessAutomatic) {
+        shell_print(sh, "brightness: auto");
+    } else {
+        shell_print(sh, "brightness: %d", brightness >> 4);
+    }
+
+    return 0;
+}
+
+int ClockShell::settingsCommand(const struct shell *sh, size_t argc, char **argv)
+{
+    if (!isReady(sh)) {
+        return -EAGAIN;
+    }
+
+    //the keys that are not used yet are loaded here
+    clockSettings->load();
+
+    printRule(sh, "dst", true);
+    printRule(sh, "std", false);
+
+    shell_print(sh, "hourly alarm: %s", clockSettings->getHourlyAlarm() ? "on" : "off");
+    shell_print(sh, "temperature: %s", (clockSettings->getFormatTemperature() == ClockSettings::formatFahrenheit)
+        ? "Fahrenheit" : "Celsius");
+    shell_print(sh, "hour format: %s", (clockSettings->getFormatHour() == ClockSettings::formatHour12)
+        ? "12-hour" : "24-hour");
+    shell_print(sh, "correction offset: %+d", clockTime->getCorrectionOffset());
+
+    int16_t brightness = clockDisplay->getBrightnessOverride();
+
+    if (brightness == ClockDisplay::brightnessAutomatic) {
+        shell_print(sh, "brightness: auto");
+    } else {
+        shell_print(sh, "brightness: %d", brightness >> 4);
+    }
+
+    return 0;
+}
+
+int ClockShell::diagCommand(const struct shell *sh, size_t argc, char **argv)
+{
+    const char *lastMissed = ClockWatchdog::getLastMissed();
+
+    shell_print(sh, "uptime: %u s", k_uptime_get_32() / MSEC_PER_SEC);
+    shell_print(sh, "last watchdog miss: %s", (lastMissed != NULL) ? lastMissed : "none");
+
+    //the boot profile goes to the log
+    ClockBootProfile::dump();
+
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(clockCommands,
+    SHELL_CMD_ARG(time, NULL, "Get or set the time: [hh:mm[:ss] [yyyy-mm-dd]]", ClockShell::timeCommand, 1, 2),
+    SHELL_CMD_ARG(dst, NULL, "Get or set the daylight time start: [week weekday month hour offset]",
+        ClockShell::dstCommand, 1, 5),
+    SHELL_CMD_ARG(std, NULL, "Get or set the standard time start: [week weekday month hour offset]",
+        ClockShell::stdCommand, 1, 5),
+    SHELL_CMD_ARG(alarm, NULL, "Get or set the hourly alarm: [on|off]", ClockShell::alarmCommand, 1, 1),
+    SHELL_CMD_ARG(offset, NULL, "Get or set the RTC correction offset: [-32..31]", ClockShell::offsetCommand, 1, 1),
+    SHELL_CMD_ARG(brightness, NULL, "Get or set the brightness override: [auto|0..15]",
+        ClockShell::brightnessCommand, 1, 1),
+    SHELL_CMD(settings, NULL, "Print all the settings", ClockShell::settingsCommand),
+    SHELL_CMD(diag, NULL, "Print the last watchdog miss and the boot profile", ClockShell::diagCommand),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(clock, &clockCommands, "Clock configuration and diagnostics", NULL);
+#endif
@@ -0,0 +1,178 @@
+#include <ClockTemperatureHistory.h>
+
+LOG_MODULE_REGISTER(clock_temperature_history, CONFIG_APP_SENSORS_LOG_LEVEL);
+
+ClockTemperatureHistory::ClockTemperatureHistory()
+{
+    k_mutex_init(&mutexHistory);
+
+    rtc = DEVICE_DT_GET(DT_COMPAT_GET_ANY_STATUS_OKAY(microcrystal_rv3032));
+}
+
+int8_t ClockTemperatureHistory::toHalfDegrees(int temperature)
+{
+    //round to the nearest half degree
+    int halfDegrees = (temperature + ((temperature < 0) ? -2 : 2)) / 5;
+
+    return (int8_t)CLAMP(halfDegrees, INT8_MIN + 1, INT8_MAX - 1);
+}
+
+void ClockTemperatureHistory::add(int temperature)
+{
+    int8_t sample = toHalfDegrees(temperature);
+
+    k_mutex_lock(&mutexHistory, K_FOREVER);
+
+    //the RTC is read on the first sample, not at the boot
+    if (!restored) {
+        restored = true;
+        restore();
+    }
+
+    int8_t previousMinimum = minimum;
+    int8_t previousMaximum = maximum;
+
+    push(sample);
+
+    if (IS_ENABLED(CONFIG_APP_TEMPERATURE_HISTORY_RTC_RAM)) {
+        persist(sample, minimum != previousMinimum, maximum != previousMaximum);
+    }
+
+    k_mutex_unlock(&mutexHistory);
+
+    LOG_DBG("Temperature history: %d samples, min: %d, max: %d", count, minimum * 5, maximum * 5);
+}
+
+void ClockTemperatureHistory::push(int8_t sample)
+{
+    samples[head] = sample;
+    head = (head + 1) % size;
+
+    if (count < size) {
+        count++;
+    }
+
+    if (sample < minimum) {
+        minimum = sample;
+    }
+
+    if (sample > maximum) {
+        maximum = sample;
+    }
+}
+
+bool ClockTemperatureHistory::isEmpty()
+{
+    return (count == 0);
+}
+
+int ClockTemperatureHistory::getMinimum()
+{
+    return minimum * 5;
+}
+
+int ClockTemperatureHistory::getMaximum()
+{
+    return maximum * 5;
+}
+
+int ClockTemperatureHistory::getTrend()
+{
+    int trend = 0;
+
+    k_mutex_lock(&mutexHistory, K_FOREVER);
+
+    if (count > 1) {
+        uint8_t back = MIN(trendSamples, count - 1);
+        int8_t newest = samples[(head + size - 1) % size];
+        int8_t older = samples[(head + size - 1 - back) % size];
+
+        trend = (newest - older) * 5;
+    }
+
+    k_mutex_unlock(&mutexHistory);
+
+    return trend;
+}
+
+void ClockTemperatureHistory::restore()
+{
+    uint8_t ram[0x50 - ramStart];
+
+    uint32_t resetCause = 0;
+
+    if (!IS_ENABLED(CONFIG_APP_TEMPERATURE_HISTORY_RTC_RAM) || !device_is_ready(rtc)) {
+        return;
+    }
+
+    //the RTC RAM is kept by the backup battery, so a power-up starts a new trip
+    if (hwinfo_get_reset_cause(&resetCause) == 0) {
+        hwinfo_clear_reset_cause();
+
+        if (resetCause & (RESET_POR | RESET_BROWNOUT)) {
+            LOG_INF("New trip, the temperature history is cleared");
+            return;
+        }
+    }
+
+    for (uint8_t i = 0; i < sizeof(ram); i++) {
+        if (rtc_ram_read(rtc, ramStart + i, &ram[i]) != 0) {
+            return;
+        }
+    }
+
+    uint8_t savedCount = ram[ramCount - ramStart];
+    uint8_t savedHead = ram[ramHead - ramStart];
+    int8_t savedMinimum = (int8_t)ram[ramMinimum - ramStart];
+    int8_t savedMaximum = (int8_t)ram[ramMaximum - ramStart];
+
+    if ((ram[ramMagic - ramStart] != ramMagicValue) || (savedCount > ramSize) || (savedHead >= ramSize)
+        || (savedMinimum > savedMaximum)) {
+        LOG_DBG("No temperature history in the RTC RAM");
+        return;
+    }
+
+    //the oldest saved sample goes first
+    for (uint8_t i = 0; i < savedCount; i++) {
+        push((int8_t)ram[ramSamples - ramStart + (savedHead + ramSize - savedCount + i) % ramSize]);
+    }
+
+    minimum = MIN(minimum, savedMinimum);
+    maximum = MAX(maximum, savedMaximum);
+
+    ramPosition = savedHead;
+    ramSampleCount = savedCount;
+
+    LOG_INF("Restored %u temperature samples from the RTC RAM", savedCount);
+}
+
+void ClockTemperatureHistory::persist(int8_t sample, bool minimumChanged, bool maximumChanged)
+{
+    if (!device_is_ready(rtc)) {
+        return;
+    }
+
+    //only the changed registers are written
+    rtc_ram_write(rtc, ramSamples + ramPosition, (uint8_t)sample);
+
+    ramPosition = (ramPosition + 1) % ramSize;
+    rtc_ram_write(rtc, ramHead, ramPosition);
+
+    if (ramSampleCount < ramSize) {
+        ramSampleCount++;
+        rtc_ram_write(rtc, ramCount, ramSampleCount);
+    }
+
+    if (minimumChanged) {
+        rtc_ram_write(rtc, ramMinimum, (uint8_t)minimum);
+    }
+
+    if (maximumChanged) {
+        rtc_ram_write(rtc, ramMaximum, (uint8_t)maximum);
+    }
+
+    //the magic is written once, after the first complete record
+    if (ramSampleCount == 1) {
+        rtc_ram_write(rtc, ramMagic, ramMagicValue);
+    }
+}
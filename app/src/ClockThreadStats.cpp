@@ -0,0 +1,198 @@
+#include <ClockThreadStats.h>
+
+#include <zephyr/shell/shell.h>
+
+LOG_MODULE_REGISTER(clock_thread_stats, CONFIG_APP_LOG_LEVEL);
+
+ClockThreadStatsEntry ClockThreadStats::threads[ClockThreadStats::maxThreads];
+
+uint8_t ClockThreadStats::numberOfThreads = 0;
+
+uint64_t ClockThreadStats::totalCycles = 0;
+
+uint64_t ClockThreadStats::periodCycles = 0;
+
+struct k_work_delayable ClockThreadStats::sampleWork;
+
+struct k_mutex ClockThreadStats::mutexStats;
+
+void ClockThreadStats::init()
+{
+#ifdef CONFIG_APP_THREAD_STATS
+    k_mutex_init(&mutexStats);
+
+    //the first sample is taken after the threads ran for a period
+    k_work_init_delayable(&sampleWork, sampleWorkHandler);
+    k_work_schedule(&sampleWork, K_SECONDS(CONFIG_APP_THREAD_STATS_PERIOD));
+#endif
+}
+
+void ClockThreadStats::sampleWorkHandler(struct k_work *work)
+{
+#ifdef CONFIG_APP_THREAD_STATS
+    sample();
+
+    k_work_schedule(&sampleWork, K_SECONDS(CONFIG_APP_THREAD_STATS_PERIOD));
+#endif
+}
+
+void ClockThreadStats::sample()
+{
+#ifdef CONFIG_APP_THREAD_STATS
+    k_thread_runtime_stats_t stats;
+
+    if (k_mutex_lock(&mutexStats, K_MSEC(300)) != 0) {
+        LOG_ERR("Cannot lock the thread statistics for sampling");
+        return;
+    }
+
+    //the cycles of all the threads with the idle thread are the time between the samples
+    k_thread_runtime_stats_all_get(&stats);
+
+    periodCycles = stats.execution_cycles - totalCycles;
+    totalCycles = stats.execution_cycles;
+
+    //the stacks are scanned without the scheduler lock
+    k_thread_foreach_unlocked(sampleThread, NULL);
+
+    k_mutex_unlock(&mutexStats);
+#endif
+}
+
+ClockThreadStatsEntry *ClockThreadStats::findThread(const struct k_thread *thread)
+{
+    for (uint8_t i = 0; i < numberOfThreads; i++) {
+        if (threads[i].thread == thread) {
+            return &threads[i];
+        }
+    }
+
+    if (numberOfThreads >= maxThreads) {
+        return NULL;
+    }
+
+    ClockThreadStatsEntry *entry = &threads[numberOfThreads++];
+
+    memset(entry, 0, sizeof(*entry));
+    entry->thread = thread;
+
+    return entry;
+}
+
+void ClockThreadStats::sampleThread(const struct k_thread *thread, void *userData)
+{
+#ifdef CONFIG_APP_THREAD_STATS
+    k_tid_t threadId = (k_tid_t)thread;
+    ClockThreadStatsEntry *entry = findThread(thread);
+
+    if (entry == NULL) {
+        LOG_WRN("Too many threads for the statistics");
+        return;
+    }
+
+    const char *name = k_thread_name_get(threadId);
+
+    if ((name != NULL) && (name[0] != '\0')) {
+        strncpy(entry->name, name, sizeof(entry->name) - 1);
+    } else {
+        snprintf(entry->name, sizeof(entry->name), "%p", (void *)thread);
+    }
+
+    k_thread_runtime_stats_t stats;
+
+    if (k_thread_runtime_stats_get(threadId, &stats) == 0) {
+        uint64_t cycles = stats.execution_cycles - entry->cycles;
+
+        entry->load = (periodCycles > 0) ? (uint16_t)(cycles * 1000 / periodCycles) : 0;
+        entry->cycles = stats.execution_cycles;
+    }
+
+    size_t unused = 0;
+
+    entry->stackSize = thread->stack_info.size;
+
+    if (k_thread_stack_space_get(threadId, &unused) == 0) {
+        entry->stackUsed = entry->stackSize - unused;
+    }
+
+    //the risk is logged once for every thread
+    if (!entry->warned && (getStackPercent(entry) > stackRiskPercent)) {
+        LOG_WRN("The thread %s uses %u of %u stack bytes", entry->name, entry->stackUsed, entry->stackSize);
+        entry->warned = true;
+    }
+#endif
+}
+
+uint8_t ClockThreadStats::getNumberOfThreads()
+{
+    return numberOfThreads;
+}
+
+ClockThreadStatsEntry ClockThreadStats::getThread(uint8_t number)
+{
+    ClockThreadStatsEntry copy = {};
+
+    if (number >= numberOfThreads) {
+        return copy;
+    }
+
+    if (k_mutex_lock(&mutexStats, K_MSEC(300)) == 0) {
+        copy = threads[number];
+
+        k_mutex_unlock(&mutexStats);
+    }
+
+    return copy;
+}
+
+#if defined(CONFIG_SHELL) && defined(CONFIG_APP_THREAD_STATS)
+/**
+ * Prints the statistics of the last sample and the stacks to shrink or to grow
+ */
+static int threadsShow(const struct shell *sh, size_t argc, char **argv)
+{
+    uint8_t numberOfThreads = ClockThreadStats::getNumberOfThreads();
+
+    if (numberOfThreads == 0) {
+        shell_print(sh, "The threads are not sampled yet");
+        return 0;
+    }
+
+    shell_print(sh, "%-16s %6s %6s %4s %6s", "thread", "stack", "used", "%", "load");
+
+    for (uint8_t i = 0; i < numberOfThreads; i++) {
+        ClockThreadStatsEntry entry = ClockThreadStats::getThread(i);
+        uint8_t percent = ClockThreadStats::getStackPercent(&entry);
+        const char *flag = "";
+
+        if (percent > ClockThreadStats::stackRiskPercent) {
+            flag = "risk";
+        } else if (percent < ClockThreadStats::stackShrinkPercent) {
+            flag = "shrink";
+        }
+
+        shell_print(sh, "%-16s %6u %6u %3u%% %3u.%u%% %s", entry.name, entry.stackSize, entry.stackUsed, percent,
+            entry.load / 10, entry.load % 10, flag);
+    }
+
+    return 0;
+}
+
+/**
+ * Samples the threads now and prints the statistics
+ */
+static int threadsSample(const struct shell *sh, size_t argc, char **argv)
+{
+    ClockThreadStats::sample();
+
+    return threadsShow(sh, argc, argv);
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(threadsCommands,
+    SHELL_CMD(show, NULL, "Print the statistics of the last sample", threadsShow),
+    SHELL_CMD(sample, NULL, "Sample the threads now and print the statistics", threadsSample),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(threads, &threadsCommands, "Clock thread runtime and stack statistics", threadsShow);
+#endif
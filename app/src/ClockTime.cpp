@@ -1,5 +1,7 @@
 #include <ClockTime.h>
 
+LOG_MODULE_REGISTER(clock_time, CONFIG_APP_TIME_LOG_LEVEL);
+
 // Sunday is 0
 const char ClockTime::weekdayNames[][4] = {"Sun", "Mon", "Tue", "Wed", 
     "Thu", "Fri", "Sat"};
@@ -12,7 +14,7 @@ struct rtc_alarm_cfg ClockTime::alarmConf = {alarmCallback, NULL};
 struct k_sem ClockTime::alarmSemaphore;
 
 ClockTime::ClockTime(ClockSettings *clockSettings) 
-    : tm(), tmUtc(), timezone(&clockSettings->dstRule, &clockSettings->stdRule, 2020)
+    : tm(), tmUtc(), timezone(clockSettings->getDstRule(), clockSettings->getStdRule(), 2020)
 {
     k_mutex_init(&mutexRtc);
 
@@ -20,12 +22,12 @@ ClockTime::ClockTime(ClockSettings *clockSettings)
 
     this->clockSettings = clockSettings;
 
-    printk("\nget device rv_3032\n");
+    LOG_DBG("get device rv_3032");
     //rtc = device_get_binding(DT_LABEL(DT_INST(0, microcrystal_rv3032)));
     rtc = DEVICE_DT_GET(DT_COMPAT_GET_ANY_STATUS_OKAY(microcrystal_rv3032));
     
     if (!rtc) {
-        printk("Device Microcrystal_rv3032 not found.\n");
+        LOG_ERR("Device Microcrystal_rv3032 not found");
         return;
     }
 
@@ -44,24 +46,28 @@ ClockTime::ClockTime(ClockSettings *clockSettings)
     setRtcTime();
 */
 
-    printk("Settime Time: %.2d:%.2d:%.2d", tm.tm_hour, tm.tm_min, tm.tm_sec);
-
-    printk(", Date: %.2d-%.2d-%.2d\n", tm.tm_year, tm.tm_mon, tm.tm_mday);
+    LOG_DBG("Settime Time: %.2d:%.2d:%.2d, Date: %.2d-%.2d-%.2d", tm.tm_hour, tm.tm_min, tm.tm_sec, tm.tm_year, tm.tm_mon, tm.tm_mday);
 
     getRtcTime();
 };
 
 int64_t ClockTime::getRtcTime()
 {
-    printk("Getting time\n");
+    LOG_DBG("Getting time");
     
     if (k_mutex_lock(&mutexRtc, K_MSEC(300)) == 0) {
+        uint32_t start = ClockMetrics::startTimer();
+
         //read the UTC time from RTC
         rtc_get_time(rtc, &tmUtc);
 
+        ClockMetrics::recordTime(ClockMetrics::histogramRtcReadTime, start);
+        ClockMetrics::count(ClockMetrics::counterRtcReads);
+
         k_mutex_unlock(&mutexRtc);
     } else {
-        printk("Cannot lock RTC for reading\n");
+        ClockMetrics::count(ClockMetrics::counterMutexTimeouts);
+        LOG_ERR("Cannot lock RTC for reading");
     }
 
     //convert the UTC time to the UNIX format
@@ -69,15 +75,13 @@ int64_t ClockTime::getRtcTime()
     //get the local time in the UNIX format
     int64_t currentTimeLocal = timezone.toLocal(currentTime, getYear());
 
-    printk("currentTime: %lld\n", currentTime);
-    printk("currentTimeLocal: %lld\n", currentTimeLocal);
+    LOG_DBG("currentTime: %lld", currentTime);
+    LOG_DBG("currentTimeLocal: %lld", currentTimeLocal);
 
     //convert the UNIX time to the struct tm
     ClockTimeLib::gmtime(currentTimeLocal, &tm);
 
-    printk("getRtcTime: %.2d:%.2d:%.2d", tm.tm_hour, tm.tm_min, tm.tm_sec);
-
-    printk(", Date: %.2d-%.2d-%.2d\n", tm.tm_year, tm.tm_mon, tm.tm_mday);
+    LOG_DBG("getRtcTime: %.2d:%.2d:%.2d, Date: %.2d-%.2d-%.2d", tm.tm_hour, tm.tm_min, tm.tm_sec, tm.tm_year, tm.tm_mon, tm.tm_mday);
 
     return currentTimeLocal;
 }
@@ -85,7 +89,7 @@ int64_t ClockTime::getRtcTime()
 
 int ClockTime::setRtcTime()
 {
-    printk("Setting RTC time\n");
+    LOG_DBG("Setting RTC time");
 
     //get the UNIX time in the local timezone
     int64_t timeLocal = ClockTimeLib::mktime(&tm);
@@ -95,11 +99,9 @@ int ClockTime::setRtcTime()
     //convert the UTC UNIX time to the tm structure
     ClockTimeLib::gmtime(timeUtc, &tmUtc);
 
-    printk("Before timeUtc: %lld\n", timeUtc);
+    LOG_DBG("Before timeUtc: %lld", timeUtc);
 
-    printk("Before setRtcTime: %.2d:%.2d:%.2d", tmUtc.tm_hour, tmUtc.tm_min, tmUtc.tm_sec);
-
-    printk(", Date: %.2d-%.2d-%.2d\n", tmUtc.tm_year, tmUtc.tm_mon, tmUtc.tm_mday);
+    LOG_DBG("Before setRtcTime: %.2d:%.2d:%.2d, Date: %.2d-%.2d-%.2d", tmUtc.tm_hour, tmUtc.tm_min, tmUtc.tm_sec, tmUtc.tm_year, tmUtc.tm_mon, tmUtc.tm_mday);
 
 
     if (k_mutex_lock(&mutexRtc, K_MSEC(300)) == 0) {
@@ -109,11 +111,9 @@ int ClockTime::setRtcTime()
         k_mutex_unlock(&mutexRtc);
     }
 
-    printk("timeUtc: %lld\n", timeUtc);
-
-    printk("setRtcTime: %.2d:%.2d:%.2d", tmUtc.tm_hour, tmUtc.tm_min, tmUtc.tm_sec);
+    LOG_DBG("timeUtc: %lld", timeUtc);
 
-    printk(", Date: %.2d-%.2d-%.2d\n", tmUtc.tm_year, tmUtc.tm_mon, tmUtc.tm_mday);
+    LOG_DBG("setRtcTime: %.2d:%.2d:%.2d, Date: %.2d-%.2d-%.2d", tmUtc.tm_hour, tmUtc.tm_min, tmUtc.tm_sec, tmUtc.tm_year, tmUtc.tm_mon, tmUtc.tm_mday);
 
     return 0;
 }
@@ -132,11 +132,15 @@ uint8_t ClockTime::getDaysInMonth()
 
 void ClockTime::alarmCallback(const struct device *dev, void *user_data)
 {
-    printk("=========\nIn alarmCallback\n");
+    LOG_DBG("In alarmCallback");
 
 
-    //send the semaphore signal to the ClockAlarm thread
-    k_sem_give(&alarmSemaphore);
+    //send the semaphore signal to the ClockAlarm thread or the event loop
+    if (IS_ENABLED(CONFIG_APP_EVENT_LOOP)) {
+        ClockEventLoop::post(ClockEventLoop::eventAlarm);
+    } else {
+        k_sem_give(&alarmSemaphore);
+    }
 }
 
 void ClockTime::setAlarmInterrupt()
@@ -1,5 +1,7 @@
 #include <ClockTimezone.h>
 
+LOG_MODULE_REGISTER(clock_timezone, CONFIG_APP_TIME_LOG_LEVEL);
+
 // Week names for timezone changes
 const char ClockTimezone::weekNames[][6] = {"Last", "First", "Sec", "Third", "Four"};
 
@@ -39,7 +41,7 @@ void ClockTimezone::setRules(TimeChangeRule *dstRule, TimeChangeRule *stdRule, u
 
 void ClockTimezone::calculateTimeChange()
 {
-    printk("Timezone year: %ld\n", (long)year);
+    LOG_DBG("Timezone year: %ld", (long)year);
 
     startDst = mktime(dstRule);
     startDstUtc = startDst - stdRule->offset * 60;
@@ -47,11 +49,11 @@ void ClockTimezone::calculateTimeChange()
     startStd = mktime(stdRule);
     startStdUtc = startStd - dstRule->offset * 60;
 
-    printk("startDst time: %lld\n", startDst);
-    printk("startStd time: %lld\n", startStd);
+    LOG_DBG("startDst time: %lld", startDst);
+    LOG_DBG("startStd time: %lld", startStd);
 
-    printk("startDstUtc time: %lld\n", startDstUtc);
-    printk("startStdUtc time: %lld\n", startStdUtc);
+    LOG_DBG("startDstUtc time: %lld", startDstUtc);
+    LOG_DBG("startStdUtc time: %lld", startStdUtc);
 
 }
 
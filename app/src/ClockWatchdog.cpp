@@ -1,58 +1,99 @@
 #include <ClockWatchdog.h>
 
-ClockWatchdog::ClockWatchdog()
+LOG_MODULE_REGISTER(clock_watchdog, CONFIG_APP_LOG_LEVEL);
+
+bool ClockWatchdog::initialized = false;
+
+__noinit ClockWatchdogReport ClockWatchdog::report;
+
+char ClockWatchdog::lastMissed[sizeof(report.name)];
+
+int ClockWatchdog::init()
 {
-    printk("Init Device Watchdog.\n");
+    LOG_DBG("Initializing the Watchdog");
 
-    watchdog = DEVICE_DT_GET(DT_INST(0, st_stm32_watchdog));
-    
-    if (!watchdog) {
-        printk("Device Watchdog IWDT not found.\n");
-        return;
+    //the no init RAM is random after a power-up, the magic marks the stored report
+    if (report.magic == reportMagic) {
+        memcpy(lastMissed, report.name, sizeof(lastMissed));
+        lastMissed[sizeof(lastMissed) - 1] = '\0';
+
+        LOG_WRN("Watchdog: the thread %s missed its deadline at %u ms", lastMissed, report.uptime);
+    }
+
+    report.magic = 0;
+
+    const struct device *watchdog = DEVICE_DT_GET(DT_INST(0, st_stm32_watchdog));
+
+    if (!device_is_ready(watchdog)) {
+        LOG_ERR("Device Watchdog IWDT not found");
+        watchdog = NULL;
+    }
+
+    //the task watchdog timer feeds the IWDG, the IWDG resets the clock if the timer stops
+    int ret = task_wdt_init(watchdog);
+    if (ret != 0) {
+        LOG_ERR("Task watchdog init error: %d", ret);
+        return ret;
     }
 
-    init();
+    initialized = true;
+
+    return 0;
 }
 
-int ClockWatchdog::init()
+const char *ClockWatchdog::getLastMissed()
 {
-    printk("Initializing the Watchdog\n");
+    return (lastMissed[0] != '\0') ? lastMissed : NULL;
+}
 
-    if (!watchdog) {
-        return -1;
-    }
+ClockWatchdog::ClockWatchdog(const char *name, uint32_t deadline)
+{
+    LOG_DBG("Init the Watchdog channel %s", name);
+
+    this->name = name;
+    this->deadline = deadline;
 
-    struct wdt_timeout_cfg watchdogConfig = {
-        // Expire watchdog after max window
-        .window = {
-            .min = 0U,
-            .max = 26214,
-        },
-        //no callback for IWDT
-        .callback = NULL,
-        // Reset SoC when watchdog timer expires.
-        .flags = WDT_FLAG_RESET_SOC,
-    };
+    if (!initialized) {
+        watchdogChannelId = -1;
+        return;
+    }
 
-    watchdogChannelId = wdt_install_timeout(watchdog, &watchdogConfig);
+    watchdogChannelId = task_wdt_add(deadline, missed, this);
 
     if (watchdogChannelId < 0) {
-        printk("Watchdog install error\n");
-        return -1;
+        LOG_ERR("Watchdog install error");
     }
+}
+
+void ClockWatchdog::missed(int channelId, void *userData)
+{
+    ClockWatchdog *watchdog = (ClockWatchdog *)userData;
 
-    feed();
+    strncpy(report.name, watchdog->name, sizeof(report.name) - 1);
+    report.name[sizeof(report.name) - 1] = '\0';
+    report.uptime = k_uptime_get_32();
+    report.magic = reportMagic;
 
-    return 0;
+    LOG_WRN("Watchdog: the thread %s missed its deadline", watchdog->name);
+
+    //the deferred messages are lost after the reboot
+    LOG_PANIC();
+
+    sys_reboot(SYS_REBOOT_COLD);
 }
 
 void ClockWatchdog::feed()
 {
-    printk("===Feeding the Watchdog===\n");
+    LOG_DBG("Feeding the Watchdog %s", name);
 
-    if (!watchdog) {
+    if (watchdogChannelId < 0) {
         return;
     }
 
-    wdt_feed(watchdog, watchdogChannelId);
+    task_wdt_feed(watchdogChannelId);
+}
+
+k_timeout_t ClockWatchdog::getWaitTimeout()
+{
+    return K_MSEC(deadline / 2);
 }
@@ -8,7 +8,7 @@
 #include "app_version.h"
 
 #include <zephyr/logging/log.h>
-LOG_MODULE_REGISTER(main, LOG_LEVEL_INF);
+LOG_MODULE_REGISTER(main, CONFIG_APP_LOG_LEVEL);
 
 #include <zephyr/device.h>
 #include <zephyr/devicetree.h>
@@ -28,61 +28,107 @@ LOG_MODULE_REGISTER(main, LOG_LEVEL_INF);
 
 #include <ClockAlarm.h>
 #include <ClockBackgroundLight.h>
+#include <ClockBootProfile.h>
+#include <ClockBrightness.h>
 #include <ClockButtons.h>
 #include <ClockDisplay.h>
+#include <ClockEventLoop.h>
+#include <ClockLatency.h>
 #include <ClockLightSensor.h>
+#include <ClockMetrics.h>
 #include <ClockSettings.h>
+#include <ClockShell.h>
 #include <ClockTemperature.h>
+#include <ClockThreadStats.h>
 #include <ClockTime.h>
 #include <ClockTimezone.h>
 #include <ClockWatchdog.h>
 
+#ifdef CONFIG_APP_EVENT_LOOP
+//all the tasks run in the display thread, the buttons need the largest stack
+K_THREAD_STACK_DEFINE(displayStackArea, 4096);
+#else
 K_THREAD_STACK_DEFINE(displayStackArea, 2048);
 K_THREAD_STACK_DEFINE(buttonsStackArea, 4096);
 K_THREAD_STACK_DEFINE(lightSensorStackArea, 2048);
 K_THREAD_STACK_DEFINE(alarmStackArea, 2048);
 K_THREAD_STACK_DEFINE(backgroundLightStackArea, 2048);
+#endif
 
 
 static k_tid_t displayThreadId;
 
+//the task watchdog deadlines of the threads in ms,
+//they cover the longest work of the thread: scrolling the text, auto ranging the light sensor or playing the gong
+static const uint32_t displayDeadline = 30000;
+static const uint32_t buttonsDeadline = 30000;
+static const uint32_t brightnessDeadline = 60000;
+static const uint32_t alarmDeadline = 30000;
+static const uint32_t backgroundLightDeadline = 30000;
+static const uint32_t eventLoopDeadline = 60000;
+
+//the light sampling period in the event loop while the light is changing in ms
+static const uint32_t lightChangingPeriod = 1000;
+
 /**
  * Processes buttons
  */
 void processButtons(void *clockSettings, void *clockTime, void *clockDisplay)
 {
-    printk("In processButtons\n");
+    LOG_DBG("In processButtons");
 
-    printk("in buttons, threadId: %lu, currentThreadId: %lu\n", (unsigned long)displayThreadId, (unsigned long)k_current_get());
+    LOG_DBG("in buttons, threadId: %lu, currentThreadId: %lu", (unsigned long)displayThreadId, (unsigned long)k_current_get());
+
+    ClockWatchdog watchdog("buttons", buttonsDeadline);
 
     ClockButtons clockButtons((ClockSettings*)clockSettings, (ClockTime*)clockTime, (ClockDisplay*)clockDisplay);
 
-    clockButtons.processButtonActions();
+    clockButtons.processButtonActions(&watchdog);
 }
 
 
+/**
+ * Sets the brightness of the display from the current light level
+ *
+ * @return bool True if the light level is settled
+ */
+static bool updateBrightness(ClockLightSensor *lightSensor, ClockBrightness *brightness, ClockDisplay *clockDisplay)
+{
+    //the display is written only when the level changes
+    if (brightness->update(lightSensor->getLightMilliLux())) {
+        clockDisplay->setBrightness(brightness->getBrightness());
+    }
+
+    //the sensor refresh time is short only while the light is changing
+    lightSensor->setPowerSaving(brightness->getPowerSavingMode());
+
+    return brightness->isSettled();
+}
+
 /**
  * Sets the brightness of the display depending on the light level
  */
-void adjustBrightness(void *clockSettings, void *clockDisplayInput, void*)
+void adjustBrightness(void *clockLightSensor, void *clockDisplayInput, void*)
 {
-    //use this thread as watchdog
-    ClockWatchdog watchdog;
+    ClockWatchdog watchdog("brightness", brightnessDeadline);
 
-    ClockLightSensor lightSensor;
+    ClockLightSensor *lightSensor = (ClockLightSensor*)clockLightSensor;
+    ClockBrightness brightness;
     ClockDisplay *clockDisplay = (ClockDisplay*)clockDisplayInput;
 
     while(1) {
-        uint8_t brightness = lightSensor.getBrightness();
-
-        clockDisplay->setBrightness(brightness);
+        bool settled = updateBrightness(lightSensor, &brightness, clockDisplay);
 
-        //feed the watchdog, the thread runs well
+        //feed the watchdog channel, the thread runs well
         watchdog.feed();
 
-        printk("Sleeping in adjustBrightness\n");
-        //it must be smaller than the Watchdog window.max value
-        k_msleep(18000);
+        LOG_DBG("Sleeping in adjustBrightness");
+        //wakes up when the light leaves the threshold window around the current level,
+        //while the filter is still moving it samples every second
+        //the timeout must be smaller than the watchdog deadline
+        lightSensor->waitForChange(settled ? watchdog.getWaitTimeout() : K_MSEC(lightChangingPeriod));
+
+        ClockMetrics::countWakeup();
     }
 
     return;
@@ -93,9 +139,11 @@ void adjustBrightness(void *clockSettings, void *clockDisplayInput, void*)
  */
 void processAlarm(void *clockSettings, void *clockTime, void*)
 {
+    ClockWatchdog watchdog("alarm", alarmDeadline);
+
     ClockAlarm alarm((ClockSettings*)clockSettings, (ClockTime*)clockTime);
 
-    alarm.process();
+    alarm.process(&watchdog);
 
     return;
 }
@@ -105,80 +153,204 @@ void processAlarm(void *clockSettings, void *clockTime, void*)
  */
 void processBackgroundLight(void *clockDisplay, void*, void*)
 {
+    ClockWatchdog watchdog("background", backgroundLightDeadline);
+
     ClockBackgroundLight backgroundLight((ClockDisplay*)clockDisplay);
 
-    backgroundLight.process();
+    backgroundLight.process(&watchdog);
 
     return;
 }
 
+/**
+ * Runs all the clock tasks in the display thread instead of their own threads
+ * The handlers of the posted events run in the order of the event bits.
+ * The display refresh and the light sampling also run when their time comes.
+ */
+static void runEventLoop(ClockSettings *clockSettings, ClockTime *clockTime, ClockDisplay *clockDisplay,
+    ClockLightSensor *lightSensor)
+{
+    ClockWatchdog watchdog("events", eventLoopDeadline);
+
+    ClockButtons clockButtons(clockSettings, clockTime, clockDisplay);
+    ClockAlarm alarm(clockSettings, clockTime);
+    ClockBackgroundLight backgroundLight(clockDisplay);
+    ClockBrightness brightness;
+
+    int64_t nextRefresh = k_uptime_get() + clockDisplay->getSleepTime();
+    int64_t nextLight = 0;
+
+    while (1) {
+        watchdog.feed();
+
+        int64_t now = k_uptime_get();
+        //the loop wakes up at least twice in the watchdog deadline
+        int64_t next = MIN(MIN(nextRefresh, nextLight), now + eventLoopDeadline / 2);
+
+        uint32_t events = ClockEventLoop::wait(K_MSEC(MAX(next - now, 0)));
+
+        ClockMetrics::countWakeup();
+
+        now = k_uptime_get();
+
+        if (events & ClockEventLoop::eventButton) {
+            clockButtons.processPressedButtons();
+        }
+
+        if (events & ClockEventLoop::eventAlarm) {
+            alarm.processAlarm();
+        }
+
+        if (events & ClockEventLoop::eventBackgroundLight) {
+            backgroundLight.processChange();
+        }
+
+        if ((events & ClockEventLoop::eventLight) || (now >= nextLight)) {
+            lightSensor->stopWatch();
+
+            bool settled = updateBrightness(lightSensor, &brightness, clockDisplay);
+
+            //the threshold trigger posts the light event, the timeout is the fallback
+            if (settled && (lightSensor->startWatch() == 0)) {
+                nextLight = now + eventLoopDeadline / 2;
+            } else {
+                nextLight = now + lightChangingPeriod;
+            }
+        }
+
+        if ((events & ClockEventLoop::eventDisplay) || (now >= nextRefresh)) {
+            clockTime->getRtcTime();
+            clockDisplay->show();
+
+            nextRefresh = k_uptime_get() + clockDisplay->getSleepTime();
+        }
+    }
+}
 
 void displayTime(void*, void*, void*)
 {
+    //the supervisor starts before the threads register their channels
+    ClockWatchdog::init();
+
+    //the interrupts post the events from the start
+    ClockEventLoop::init();
+
+    //the settings keys are loaded on the first access, so only the keys for the first frame are read here
     ClockSettings clockSettings;
+    ClockBootProfile::mark(ClockBootProfile::stageSettings);
 
     ClockTime clockTime(&clockSettings);
+    ClockBootProfile::mark(ClockBootProfile::stageTime);
 
     ClockTemperature clockTemperature;
+    ClockBootProfile::mark(ClockBootProfile::stageTemperature);
 
-    ClockDisplay clockDisplay(&clockSettings, &clockTime, &clockTemperature);
+    //the only owner of the light sensor, the display and the brightness thread share it
+    ClockLightSensor clockLightSensor;
+
+    ClockDisplay clockDisplay(&clockSettings, &clockTime, &clockTemperature, &clockLightSensor);
     clockDisplay.setThreadId(k_current_get());
+    ClockBootProfile::mark(ClockBootProfile::stageDisplay);
 
+    //the shell commands change the same objects as the buttons
+    ClockShell::init(&clockSettings, &clockTime, &clockDisplay);
 
-    printk("in display, threadId: %lu, currentThreadId: %lu\n", (unsigned long)displayThreadId, (unsigned long)k_current_get());
 
+    LOG_DBG("in display, threadId: %lu, currentThreadId: %lu", (unsigned long)displayThreadId, (unsigned long)k_current_get());
 
-    //creates a thread with the function processButtons
-    struct k_thread buttonsThreadData;
 
-    k_thread_create(&buttonsThreadData, buttonsStackArea,
-        K_THREAD_STACK_SIZEOF(buttonsStackArea), processButtons, &clockSettings, &clockTime, &clockDisplay, -1, 0, K_NO_WAIT);
+#ifdef CONFIG_APP_EVENT_LOOP
+    clockTime.getRtcTime();
+    clockDisplay.show();
+    ClockBootProfile::mark(ClockBootProfile::stageFirstFrame);
+
+    ClockBootProfile::mark(ClockBootProfile::stageThreads);
 
+    if (IS_ENABLED(CONFIG_APP_BOOT_PROFILE)) {
+        ClockBootProfile::dump();
+    }
+
+    runEventLoop(&clockSettings, &clockTime, &clockDisplay, &clockLightSensor);
+#else
     //creates a thread with the function adjustBrightness
+    //the light sensor init is the slowest, it runs while this thread draws the first frame
     struct k_thread lightSensorThreadData;
 
     k_thread_create(&lightSensorThreadData, lightSensorStackArea,
-        K_THREAD_STACK_SIZEOF(lightSensorStackArea), adjustBrightness, &clockSettings, &clockDisplay, NULL, 6, 0, K_MSEC(100));
+        K_THREAD_STACK_SIZEOF(lightSensorStackArea), adjustBrightness, &clockLightSensor, &clockDisplay, NULL, 6, 0, K_NO_WAIT);
+    k_thread_name_set(&lightSensorThreadData, "brightness");
+
+    //the first frame is drawn before the other threads start
+    clockTime.getRtcTime();
+    clockDisplay.show();
+    ClockBootProfile::mark(ClockBootProfile::stageFirstFrame);
+
+    //creates a thread with the function processButtons
+    struct k_thread buttonsThreadData;
+
+    k_thread_create(&buttonsThreadData, buttonsStackArea,
+        K_THREAD_STACK_SIZEOF(buttonsStackArea), processButtons, &clockSettings, &clockTime, &clockDisplay, -1, 0, K_NO_WAIT);
+    k_thread_name_set(&buttonsThreadData, "buttons");
 
     //creates a thread with the function processBackgroundLight
     struct k_thread backgroundLightThreadData;
 
     k_thread_create(&backgroundLightThreadData, backgroundLightStackArea,
-        K_THREAD_STACK_SIZEOF(backgroundLightStackArea), processBackgroundLight, &clockDisplay, NULL, NULL, 7, 0, K_MSEC(100));
+        K_THREAD_STACK_SIZEOF(backgroundLightStackArea), processBackgroundLight, &clockDisplay, NULL, NULL, 7, 0, K_NO_WAIT);
+    k_thread_name_set(&backgroundLightThreadData, "background");
 
     //creates a thread with the function processAlarm
     struct k_thread alarmThreadData;
 
     k_thread_create(&alarmThreadData, alarmStackArea,
         K_THREAD_STACK_SIZEOF(alarmStackArea), processAlarm, &clockSettings, &clockTime, NULL, 3, 0, K_NO_WAIT);
+    k_thread_name_set(&alarmThreadData, "alarm");
+
+    ClockBootProfile::mark(ClockBootProfile::stageThreads);
+
+    if (IS_ENABLED(CONFIG_APP_BOOT_PROFILE)) {
+        ClockBootProfile::dump();
+    }
 
-    //so the lightSensor process finish
-    k_msleep(300);
+    ClockWatchdog watchdog("display", displayDeadline);
 
     while(1) {
+        watchdog.feed();
+
+        //the long sleep of the other modes is cut to feed the watchdog, a wakeup still ends it early
+        k_msleep(MIN(clockDisplay.getSleepTime(), displayDeadline / 2));
+
+        ClockMetrics::countWakeup();
 
         clockTime.getRtcTime();
 
-        printk("Time: %.2d:%.2d:%.2d", clockTime.getHour(), clockTime.getMinute(), clockTime.getSecond());        
-        printk(", Date: %.2d-%.2d-%.2d, Weekday: %.2d\n", clockTime.getYear(), clockTime.getMonth(), clockTime.getDay(), clockTime.getWeekday());
+        LOG_DBG("Time: %.2d:%.2d:%.2d, Date: %.2d-%.2d-%.2d, Weekday: %.2d", clockTime.getHour(), clockTime.getMinute(), clockTime.getSecond(), clockTime.getYear(), clockTime.getMonth(), clockTime.getDay(), clockTime.getWeekday());
         
         clockDisplay.show();
-
-        k_msleep(clockDisplay.getSleepTime());
     }
+#endif
 
     return;
 }
 
 int main(void)
 {
+    ClockBootProfile::mark(ClockBootProfile::stageMain);
+
+    //the cycle counter runs before the first button press
+    ClockLatency::init();
+
     //creates a thread with the function processButtons
     struct k_thread displayThreadData;
 
     displayThreadId = k_thread_create(&displayThreadData, displayStackArea,
         K_THREAD_STACK_SIZEOF(displayStackArea), displayTime, NULL, NULL, NULL, 1, 0, K_NO_WAIT);
+    k_thread_name_set(displayThreadId, "display");
+
+    //the stacks are sampled after the threads ran for a period
+    ClockThreadStats::init();
 
-    printk("in main, threadId: %zu\n", (size_t)displayThreadId);
+    LOG_DBG("in main, threadId: %zu", (size_t)displayThreadId);
 
     return 0;
 }
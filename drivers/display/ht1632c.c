@@ -385,16 +385,16 @@ static int ht1632c_init(const struct device *dev)
     const struct ht1632c_config *config = (struct ht1632c_config *)dev->config;
     uint8_t commons_command;
 
-    printk("Configuring HT1632C\n");
+    LOG_DBG("Configuring HT1632C");
 
-    printk("Ticks per second %u\n", sys_clock_hw_cycles_per_sec());
+    LOG_DBG("Ticks per second %u", sys_clock_hw_cycles_per_sec());
 
-    printk("Delay %u\n", ht1632c_ns_to_sys_clock_hw_cycles(600));
+    LOG_DBG("Delay %u", ht1632c_ns_to_sys_clock_hw_cycles(600));
 
     data->width = 32;
     data->height = 8;
 
-    printk("Commons options (%u)\n", config->commons_options);
+    LOG_DBG("Commons options (%u)", config->commons_options);
 
     //set delays for the 4-wire protocol
     data->delays->cs = ht1632c_ns_to_sys_clock_hw_cycles(400);
@@ -404,12 +404,12 @@ static int ht1632c_init(const struct device *dev)
     data->delays->su1 = ht1632c_ns_to_sys_clock_hw_cycles(300);
     data->delays->h1 = ht1632c_ns_to_sys_clock_hw_cycles(200);
 
-    printk("Delay CS %u\n", data->delays->cs);
-    printk("Delay CLK %u\n", data->delays->clk);
-    printk("Delay SU %u\n", data->delays->su);
-    printk("Delay H %u\n", data->delays->h);
-    printk("Delay SU1 %u\n", data->delays->su1);
-    printk("Delay H1 %u\n", data->delays->h1);
+    LOG_DBG("Delay CS %u", data->delays->cs);
+    LOG_DBG("Delay CLK %u", data->delays->clk);
+    LOG_DBG("Delay SU %u", data->delays->su);
+    LOG_DBG("Delay H %u", data->delays->h);
+    LOG_DBG("Delay SU1 %u", data->delays->su1);
+    LOG_DBG("Delay H1 %u", data->delays->h1);
 
 
     if (config->cs_gpio.port != NULL) {
@@ -448,11 +448,11 @@ static int ht1632c_init(const struct device *dev)
         }
     }
 
-    printk("%s: device, GPIO pin %u is ready\n", dev->name, config->cs_gpio.pin);
-    printk("%s: device, GPIO pin %u is ready\n", dev->name, config->wr_gpio.pin);
-    printk("%s: device, GPIO pin %u is ready\n", dev->name, config->data_gpio.pin);
+    LOG_DBG("%s: device, GPIO pin %u is ready", dev->name, config->cs_gpio.pin);
+    LOG_DBG("%s: device, GPIO pin %u is ready", dev->name, config->wr_gpio.pin);
+    LOG_DBG("%s: device, GPIO pin %u is ready", dev->name, config->data_gpio.pin);
 
-    printk("HT1632C sending init commands\n");
+    LOG_DBG("HT1632C sending init commands");
 
     ht1632c_write_command(dev, HT1632_SYS_ON);
     ht1632c_write_command(dev, HT1632_LED_ON);
@@ -483,7 +483,7 @@ static int ht1632c_init(const struct device *dev)
             data->height = 8;
     }
 
-    printk("HT1632C commons command %u\n", commons_command);
+    LOG_DBG("HT1632C commons command %u", commons_command);
     ht1632c_write_command(dev, commons_command);
 
 #ifdef CONFIG_PM_DEVICE
@@ -13,7 +13,6 @@
 #include <zephyr/sys/byteorder.h>
 #include <zephyr/drivers/display.h>
 #include <zephyr/pm/device.h>
-#include <zephyr/sys/printk.h>
 #include <zephyr/logging/log.h>
 
 
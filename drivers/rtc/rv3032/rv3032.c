@@ -48,6 +48,63 @@ static int rv3032_pm_action(const struct device *dev,
 }
 #endif /* CONFIG_PM_DEVICE */
 
+/**
+ * The default does not count the I2C transactions, the application may replace it
+ */
+__weak void rtc_i2c_transaction(const struct device *dev)
+{
+    ARG_UNUSED(dev);
+}
+
+/*
+ * Every I2C transaction of the driver goes through these helpers, so it is counted
+ */
+static int rv3032_i2c_reg_read(const struct device *dev, uint8_t reg_addr, uint8_t *value)
+{
+    const struct rv3032_config *config = (struct rv3032_config *)dev->config;
+
+    rtc_i2c_transaction(dev);
+
+    return i2c_reg_read_byte_dt(&config->i2c, reg_addr, value);
+}
+
+static int rv3032_i2c_reg_write(const struct device *dev, uint8_t reg_addr, uint8_t value)
+{
+    const struct rv3032_config *config = (struct rv3032_config *)dev->config;
+
+    rtc_i2c_transaction(dev);
+
+    return i2c_reg_write_byte_dt(&config->i2c, reg_addr, value);
+}
+
+static int rv3032_i2c_burst_read(const struct device *dev, uint8_t reg_addr, uint8_t *buf, uint32_t num_bytes)
+{
+    const struct rv3032_config *config = (struct rv3032_config *)dev->config;
+
+    rtc_i2c_transaction(dev);
+
+    return i2c_burst_read_dt(&config->i2c, reg_addr, buf, num_bytes);
+}
+
+static int rv3032_i2c_write_read(const struct device *dev, const void *write_buf, size_t num_write,
+    void *read_buf, size_t num_read)
+{
+    const struct rv3032_config *config = (struct rv3032_config *)dev->config;
+
+    rtc_i2c_transaction(dev);
+
+    return i2c_write_read_dt(&config->i2c, write_buf, num_write, read_buf, num_read);
+}
+
+static int rv3032_i2c_write(const struct device *dev, const uint8_t *buf, uint32_t num_bytes)
+{
+    const struct rv3032_config *config = (struct rv3032_config *)dev->config;
+
+    rtc_i2c_transaction(dev);
+
+    return i2c_write_dt(&config->i2c, buf, num_bytes);
+}
+
 /**
  * Reads a byte from EEPROM
  * @param data Pointer to data structure
@@ -56,7 +113,6 @@ static int rv3032_pm_action(const struct device *dev,
  */
 static int rv3032_eeprom_read(const struct device *dev, const uint8_t reg_addr, uint8_t *value)
 {
-    const struct rv3032_config *config = (struct rv3032_config *)dev->config;
     struct rv3032_data *data = (struct rv3032_data *)dev->data;
 
     int ret = 0;
@@ -67,20 +123,18 @@ static int rv3032_eeprom_read(const struct device *dev, const uint8_t reg_addr,
 
     //EERD - EEPROM Memory Refresh Disable bit. When 1, disables the automatic refresh of the
     //Configuration Registers from the EEPROM Memory
-    ret = i2c_reg_read_byte_dt(&config->i2c, RV3032_CONTROL1, &control1_register);
+    ret = rv3032_i2c_reg_read(dev, RV3032_CONTROL1, &control1_register);
     if (ret != 0) {
-        LOG_ERR("read block failed");
-        printk("Error reading EERD from RTC\n");
+        LOG_ERR("Error reading EERD from RTC");
         k_mutex_unlock(&data->lock);
         return ret;
     }
     
     WRITE_BIT(control1_register, 2, 1);
 
-    i2c_reg_write_byte_dt(&config->i2c, RV3032_CONTROL1, control1_register);
+    rv3032_i2c_reg_write(dev, RV3032_CONTROL1, control1_register);
     if (ret != 0) {
-        LOG_ERR("write block failed");
-        printk("Error writing EERD to RTC\n");
+        LOG_ERR("Error writing EERD to RTC");
         k_mutex_unlock(&data->lock);
         return ret;
     }
@@ -88,11 +142,10 @@ static int rv3032_eeprom_read(const struct device *dev, const uint8_t reg_addr,
     //check if the EEPROM is not busy
     //by reading EEbusy - EEPROM Memory Busy Status Bit
     while(1) {
-        printk("Waiting for EEbusy\n");
-        ret = i2c_reg_read_byte_dt(&config->i2c, RV3032_TEMP_LSB, &temperature_lsb_register);
+        LOG_DBG("Waiting for EEbusy");
+        ret = rv3032_i2c_reg_read(dev, RV3032_TEMP_LSB, &temperature_lsb_register);
         if (ret != 0) {
-            LOG_ERR("read block failed");
-            printk("Error reading EEbusy from RTC\n");
+            LOG_ERR("Error reading EEbusy from RTC");
             k_mutex_unlock(&data->lock);
             return ret;
         }
@@ -104,18 +157,16 @@ static int rv3032_eeprom_read(const struct device *dev, const uint8_t reg_addr,
         k_msleep(2);
     }
 
-    i2c_reg_write_byte_dt(&config->i2c, RV3032_EEADDR, reg_addr);
+    rv3032_i2c_reg_write(dev, RV3032_EEADDR, reg_addr);
     if (ret != 0) {
-        LOG_ERR("write block failed");
-        printk("Error writing EEADDR to RTC\n");
+        LOG_ERR("Error writing EEADDR to RTC");
         k_mutex_unlock(&data->lock);
         return ret;
     }
 
-    i2c_reg_write_byte_dt(&config->i2c, RV3032_EECMD, 0x22);
+    rv3032_i2c_reg_write(dev, RV3032_EECMD, 0x22);
     if (ret != 0) {
-        LOG_ERR("write block failed");
-        printk("Error writing EECMD to RTC\n");
+        LOG_ERR("Error writing EECMD to RTC");
         k_mutex_unlock(&data->lock);
         return ret;
     }
@@ -123,10 +174,9 @@ static int rv3032_eeprom_read(const struct device *dev, const uint8_t reg_addr,
     //t_read = ~1.1 ms.
     k_msleep(2);
     
-    ret = i2c_reg_read_byte_dt(&config->i2c, RV3032_EEDATA, value);
+    ret = rv3032_i2c_reg_read(dev, RV3032_EEDATA, value);
     if (ret != 0) {
-        LOG_ERR("read block failed");
-        printk("Error reading EEDATA from RTC\n");
+        LOG_ERR("Error reading EEDATA from RTC");
         k_mutex_unlock(&data->lock);
         return ret;
     }
@@ -134,10 +184,9 @@ static int rv3032_eeprom_read(const struct device *dev, const uint8_t reg_addr,
     //enable auto refresh
     WRITE_BIT(control1_register, 2, 0);
 
-    i2c_reg_write_byte_dt(&config->i2c, RV3032_CONTROL1, control1_register);
+    rv3032_i2c_reg_write(dev, RV3032_CONTROL1, control1_register);
     if (ret != 0) {
-        LOG_ERR("write block failed");
-        printk("Error writing EERD to RTC\n");
+        LOG_ERR("Error writing EERD to RTC");
         k_mutex_unlock(&data->lock);
         return ret;
     }
@@ -155,7 +204,6 @@ static int rv3032_eeprom_read(const struct device *dev, const uint8_t reg_addr,
  */
 static int rv3032_eeprom_write(const struct device *dev, const uint8_t reg_addr, const uint8_t value)
 {
-    const struct rv3032_config *config = (struct rv3032_config *)dev->config;
     struct rv3032_data *data = (struct rv3032_data *)dev->data;
 
     int ret = 0;
@@ -166,20 +214,18 @@ static int rv3032_eeprom_write(const struct device *dev, const uint8_t reg_addr,
 
     //EERD - EEPROM Memory Refresh Disable bit. When 1, disables the automatic refresh of the
     //Configuration Registers from the EEPROM Memory
-    ret = i2c_reg_read_byte_dt(&config->i2c, RV3032_CONTROL1, &control1_register);
+    ret = rv3032_i2c_reg_read(dev, RV3032_CONTROL1, &control1_register);
     if (ret != 0) {
-        LOG_ERR("read block failed");
-        printk("Error reading EERD from RTC\n");
+        LOG_ERR("Error reading EERD from RTC");
         k_mutex_unlock(&data->lock);
         return ret;
     }
     
     WRITE_BIT(control1_register, 2, 1);
 
-    i2c_reg_write_byte_dt(&config->i2c, RV3032_CONTROL1, control1_register);
+    rv3032_i2c_reg_write(dev, RV3032_CONTROL1, control1_register);
     if (ret != 0) {
-        LOG_ERR("write block failed");
-        printk("Error writing EERD to RTC\n");
+        LOG_ERR("Error writing EERD to RTC");
         k_mutex_unlock(&data->lock);
         return ret;
     }
@@ -187,11 +233,10 @@ static int rv3032_eeprom_write(const struct device *dev, const uint8_t reg_addr,
     //check if the EEPROM is not busy
     //by reading EEbusy - EEPROM Memory Busy Status Bit
     while(1) {
-        printk("Waiting for EEbusy\n");
-        ret = i2c_reg_read_byte_dt(&config->i2c, RV3032_TEMP_LSB, &temperature_lsb_register);
+        LOG_DBG("Waiting for EEbusy");
+        ret = rv3032_i2c_reg_read(dev, RV3032_TEMP_LSB, &temperature_lsb_register);
         if (ret != 0) {
-            LOG_ERR("read block failed");
-            printk("Error reading EEbusy from RTC\n");
+            LOG_ERR("Error reading EEbusy from RTC");
             k_mutex_unlock(&data->lock);
             return ret;
         }
@@ -203,26 +248,23 @@ static int rv3032_eeprom_write(const struct device *dev, const uint8_t reg_addr,
         k_msleep(2);
     }
 
-    i2c_reg_write_byte_dt(&config->i2c, RV3032_EEADDR, reg_addr);
+    rv3032_i2c_reg_write(dev, RV3032_EEADDR, reg_addr);
     if (ret != 0) {
-        LOG_ERR("write block failed");
-        printk("Error writing EEADDR to RTC\n");
+        LOG_ERR("Error writing EEADDR to RTC");
         k_mutex_unlock(&data->lock);
         return ret;
     }
 
-    ret = i2c_reg_write_byte_dt(&config->i2c, RV3032_EEDATA, value);
+    ret = rv3032_i2c_reg_write(dev, RV3032_EEDATA, value);
     if (ret != 0) {
-        LOG_ERR("read block failed");
-        printk("Error reading EEDATA from RTC\n");
+        LOG_ERR("Error reading EEDATA from RTC");
         k_mutex_unlock(&data->lock);
         return ret;
     }
 
-    i2c_reg_write_byte_dt(&config->i2c, RV3032_EECMD, 0x21);
+    rv3032_i2c_reg_write(dev, RV3032_EECMD, 0x21);
     if (ret != 0) {
-        LOG_ERR("write block failed");
-        printk("Error writing EECMD to RTC\n");
+        LOG_ERR("Error writing EECMD to RTC");
         k_mutex_unlock(&data->lock);
         return ret;
     }
@@ -233,10 +275,9 @@ static int rv3032_eeprom_write(const struct device *dev, const uint8_t reg_addr,
     //enable auto refresh
     WRITE_BIT(control1_register, 2, 0);
 
-    i2c_reg_write_byte_dt(&config->i2c, RV3032_CONTROL1, control1_register);
+    rv3032_i2c_reg_write(dev, RV3032_CONTROL1, control1_register);
     if (ret != 0) {
-        LOG_ERR("write block failed");
-        printk("Error writing EERD to RTC\n");
+        LOG_ERR("Error writing EERD to RTC");
         k_mutex_unlock(&data->lock);
         return ret;
     }
@@ -256,23 +297,21 @@ static int rv3032_eeprom_write(const struct device *dev, const uint8_t reg_addr,
 
 static int rv3032_ram_read(const struct device *dev, uint8_t reg_addr, uint8_t *value)
 {
-    const struct rv3032_config *config = (struct rv3032_config *)dev->config;
     struct rv3032_data *data = (struct rv3032_data *)dev->data;
     int ret = 0;
 
     k_mutex_lock(&data->lock, K_FOREVER);
 
-    ret = i2c_reg_read_byte_dt(&config->i2c, reg_addr, value);
+    ret = rv3032_i2c_reg_read(dev, reg_addr, value);
     if (ret != 0) {
-        LOG_ERR("read register failed");
-        printk("Error reading from RAM %u\n", reg_addr);
+        LOG_ERR("Error reading from RAM %u", reg_addr);
         k_mutex_unlock(&data->lock);
         return ret;
     }
 
     k_mutex_unlock(&data->lock);
 
-    printk("Read the RAM register %u, value: %u\n", reg_addr, *value);
+    LOG_DBG("Read the RAM register %u, value: %u", reg_addr, *value);
 
     return 0;
 }
@@ -286,23 +325,21 @@ static int rv3032_ram_read(const struct device *dev, uint8_t reg_addr, uint8_t *
 
 static int rv3032_ram_write(const struct device *dev, uint8_t reg_addr, uint8_t value)
 {
-    const struct rv3032_config *config = (struct rv3032_config *)dev->config;
     struct rv3032_data *data = (struct rv3032_data *)dev->data;
     int ret = 0;
 
     k_mutex_lock(&data->lock, K_FOREVER);
 
-    ret = i2c_reg_write_byte_dt(&config->i2c, reg_addr, value);
+    ret = rv3032_i2c_reg_write(dev, reg_addr, value);
     if (ret != 0) {
-        LOG_ERR("Write RAM register failed");
-        printk("Error writing to RAM %u\n", reg_addr);
+        LOG_ERR("Error writing to RAM %u", reg_addr);
         k_mutex_unlock(&data->lock);
         return ret;
     }
 
     k_mutex_unlock(&data->lock);
 
-    printk("Wrote to the RAM register %u, value: %u\n", reg_addr, value);
+    LOG_DBG("Wrote to the RAM register %u, value: %u", reg_addr, value);
 
     return 0;
 }
@@ -322,7 +359,7 @@ static int rv3032_offset_read(const struct device *dev, int8_t *offset)
     if (ret != 0) {
         return ret;
     }
-    printk("Offset register read: %u\n", offset_register);
+    LOG_DBG("Offset register read: %u", offset_register);
 
     //read only the last 6 bits
     *offset = offset_register & 0x3f;
@@ -332,7 +369,7 @@ static int rv3032_offset_read(const struct device *dev, int8_t *offset)
         *offset -= 64;
     }
 
-    printk("Offset value read: %d\n", (int)*offset);
+    LOG_DBG("Offset value read: %d", (int)*offset);
 
     return 0;
 }
@@ -352,7 +389,7 @@ static int rv3032_offset_write(const struct device *dev, int8_t offset)
     if (ret != 0) {
         return ret;
     }
-    printk("Offset register old in write: %u\n", offset_register);
+    LOG_DBG("Offset register old in write: %u", offset_register);
 
     //the range is from -32 to +31
     if (offset > 31) {
@@ -366,11 +403,11 @@ static int rv3032_offset_write(const struct device *dev, int8_t offset)
         offset += 64;
     }
 
-    printk("Offset new: %d\n", (int)offset);
+    LOG_DBG("Offset new: %d", (int)offset);
     
     offset_register = (offset_register & 0xc0) | offset;
 
-    printk("Offset register new: %u\n", offset_register);
+    LOG_DBG("Offset register new: %u", offset_register);
 
     ret = rv3032_eeprom_write(dev, RV3032_EEPROM_OFFSET, offset_register);
     if (ret != 0) {
@@ -422,12 +459,12 @@ static int rv3032_start_calibration(const struct device *dev)
         return ret;
     }
 
-    printk("Clockout 2 register old %u\n", clkout2_register_old);
+    LOG_DBG("Clockout 2 register old %u", clkout2_register_old);
 
     //OS bit to 0 (XTAL), FD field to 11 (1 Hz)
     clkout2_register = 0x60;
 
-    printk("RV-3032 clkout2_register: %u\n", clkout2_register);
+    LOG_DBG("RV-3032 clkout2_register: %u", clkout2_register);
 
     if (clkout2_register != clkout2_register_old) {
         ret = rv3032_eeprom_write(dev, RV3032_EEPROM_PMU, pmu_register);
@@ -442,13 +479,13 @@ static int rv3032_start_calibration(const struct device *dev)
         return ret;
     }
 
-    printk("PMU register old %u\n", pmu_register_old);
+    LOG_DBG("PMU register old %u", pmu_register_old);
 
     pmu_register = pmu_register_old;
     //set to 0 to enable the output
     pmu_register |= (0 << 6);
 
-    printk("RV-3032 pmu_register: %u\n", pmu_register);
+    LOG_DBG("RV-3032 pmu_register: %u", pmu_register);
 
     if (pmu_register != pmu_register_old) {
         ret = rv3032_eeprom_write(dev, RV3032_EEPROM_PMU, pmu_register);
@@ -476,13 +513,13 @@ static int rv3032_stop_calibration(const struct device *dev)
         return ret;
     }
 
-    printk("PMU register old %u\n", pmu_register_old);
+    LOG_DBG("PMU register old %u", pmu_register_old);
 
     pmu_register = pmu_register_old;
     //set to 1 to disable the output
     pmu_register |= (1 << 6);
 
-    printk("RV-3032 pmu_register: %u\n", pmu_register);
+    LOG_DBG("RV-3032 pmu_register: %u", pmu_register);
 
     if (pmu_register != pmu_register_old) {
         ret = rv3032_eeprom_write(dev, RV3032_EEPROM_PMU, pmu_register);
@@ -496,11 +533,10 @@ static int rv3032_stop_calibration(const struct device *dev)
 
 
 /**
- * Processes alarms
+ * Processes an alarm interrupt
  */
-static void rv3032_irq_thread(const struct device *dev)
+static void rv3032_process_interrupt(const struct device *dev)
 {
-    const struct rv3032_config *config = (struct rv3032_config *)dev->config;
     struct rv3032_data *data = (struct rv3032_data *)dev->data;
 
     int ret = 0;
@@ -508,54 +544,73 @@ static void rv3032_irq_thread(const struct device *dev)
     uint8_t status_register;
     rtc_alarm_callback_t alarm_callback = data->callback;
 
-    printk("Starting rv3032_irq_thread\n");
-    while (1) {
-        is_alarm = 0;
-        k_sem_take(&data->irq_sem, K_FOREVER);
+    LOG_DBG("Processing the RV-3032 interrupt");
+    k_mutex_lock(&data->lock, K_FOREVER);
+
+    //AF status. Alarm Flag. Disable it.
+    ret = rv3032_i2c_reg_read(dev, RV3032_STATUS, &status_register);
+    if (ret != 0) {
+        LOG_ERR("Error reading AF");
+        k_mutex_unlock(&data->lock);
+        return;
+    }
+
+    LOG_DBG("status_register: %u", status_register);
 
-        printk("Processing in rv3032_irq_thread\n");
-        k_mutex_lock(&data->lock, K_FOREVER);
+    LOG_DBG("bit(3): %lu, & %lu", BIT(3), (status_register & BIT(3)));
 
-        //AF status. Alarm Flag. Disable it.
-        ret = i2c_reg_read_byte_dt(&config->i2c, RV3032_STATUS, &status_register);
+    if (status_register & BIT(3)) {
+        is_alarm = 1;
+
+        WRITE_BIT(status_register, 3, 0);
+
+        rv3032_i2c_reg_write(dev, RV3032_STATUS, status_register);
         if (ret != 0) {
-            LOG_ERR("read block failed");
-            printk("Error reading AF\n");
+            LOG_ERR("Error writing AF to RTC");
             k_mutex_unlock(&data->lock);
-            continue;
+            return;
         }
+    }
 
-        printk("status_register: %u\n", status_register);
+    k_mutex_unlock(&data->lock);
 
-        printk("bit(3): %lu, & %lu\n", BIT(3), (status_register & BIT(3)));
+    if (is_alarm && (alarm_callback != NULL)) {
+        LOG_DBG("alarm callback is called");
+        alarm_callback(dev, data->user_data);
+        LOG_DBG("alarm callback is finished");
+    }
 
-        if (status_register & BIT(3)) {
-            is_alarm = 1;
-    
-            WRITE_BIT(status_register, 3, 0);
-
-            i2c_reg_write_byte_dt(&config->i2c, RV3032_STATUS, status_register);
-            if (ret != 0) {
-                LOG_ERR("write block failed");
-                printk("Error writing AF to RTC\n");
-                k_mutex_unlock(&data->lock);
-                continue;
-            }
-        }
-        
-        k_mutex_unlock(&data->lock);
+    LOG_DBG("End processing");
+}
 
-        if (is_alarm && (alarm_callback != NULL)) {
-            printk("alarm callback is called\n");
-            alarm_callback(dev, data->user_data);
-            printk("alarm callback is finished\n");
-        }
+#ifdef CONFIG_MICROCRYSTAL_RV3032_INT_GLOBAL_THREAD
+/**
+ * Processes alarms on the system work queue
+ */
+static void rv3032_irq_work_handler(struct k_work *work)
+{
+    struct rv3032_data *data = CONTAINER_OF(work, struct rv3032_data, irq_work);
 
-        k_sem_reset(&data->irq_sem);
+    rv3032_process_interrupt(data->dev);
+}
+#else
+/**
+ * Processes alarms
+ */
+static void rv3032_irq_thread(const struct device *dev)
+{
+    struct rv3032_data *data = (struct rv3032_data *)dev->data;
 
-        printk("End processing\n");
+    LOG_DBG("Starting rv3032_irq_thread");
+    while (1) {
+        k_sem_take(&data->irq_sem, K_FOREVER);
+
+        rv3032_process_interrupt(dev);
+
+        k_sem_reset(&data->irq_sem);
     }
 }
+#endif
 
 
 /**
@@ -565,7 +620,6 @@ static void rv3032_irq_thread(const struct device *dev)
  */
 static int rv3032_get_time(const struct device *dev, struct tm *tm)
 {
-    const struct rv3032_config *config = (struct rv3032_config *)dev->config;
     struct rv3032_data *data = (struct rv3032_data *)dev->data;
     int ret = 0;
     //read starting from the seconds register
@@ -574,11 +628,10 @@ static int rv3032_get_time(const struct device *dev, struct tm *tm)
 
     k_mutex_lock(&data->lock, K_FOREVER);
 
-    ret = i2c_write_read_dt(&config->i2c, &reg, 1, time_buf, sizeof(time_buf));
+    ret = rv3032_i2c_write_read(dev, &reg, 1, time_buf, sizeof(time_buf));
 
     if (ret < 0) {
-        LOG_ERR("read block failed");
-        printk("Error reading from RTC\n");
+        LOG_ERR("Error reading from RTC");
         k_mutex_unlock(&data->lock);
         return ret;
     }
@@ -593,8 +646,7 @@ static int rv3032_get_time(const struct device *dev, struct tm *tm)
     tm->tm_mon = bcd2bin(time_buf[5]) - 1;
     tm->tm_year = bcd2bin(time_buf[6]) + 100;
 
-    printk("\nrtc_get_time: %.2d:%.2d:%.2d", tm->tm_hour, tm->tm_min, tm->tm_sec);
-    printk(", Date: %.2d-%.2d-%.2d\n", tm->tm_mday, tm->tm_mon, tm->tm_year);
+    LOG_DBG("rtc_get_time: %.2d:%.2d:%.2d, Date: %.2d-%.2d-%.2d", tm->tm_hour, tm->tm_min, tm->tm_sec, tm->tm_mday, tm->tm_mon, tm->tm_year);
 
     return 0;
 }
@@ -606,13 +658,10 @@ static int rv3032_get_time(const struct device *dev, struct tm *tm)
  */
 static int rv3032_set_time(const struct device *dev, struct tm *tm)
 {
-    const struct rv3032_config *config = (struct rv3032_config *)dev->config;
     struct rv3032_data *data = (struct rv3032_data *)dev->data;
     int ret = 0;
 
-    printk("In rtc_settime Time: %.2d:%.2d:%.2d", tm->tm_hour, tm->tm_min, tm->tm_sec);
-
-    printk(", Date: %.2d-%.2d-%.2d, Weekday: %.2d\n", tm->tm_year, tm->tm_mon, tm->tm_mday, tm->tm_wday);
+    LOG_DBG("In rtc_settime Time: %.2d:%.2d:%.2d, Date: %.2d-%.2d-%.2d, Weekday: %.2d", tm->tm_hour, tm->tm_min, tm->tm_sec, tm->tm_year, tm->tm_mon, tm->tm_mday, tm->tm_wday);
 
 
     //the buffer that contains values for the time and date
@@ -632,10 +681,9 @@ static int rv3032_set_time(const struct device *dev, struct tm *tm)
 
     k_mutex_lock(&data->lock, K_FOREVER);
 
-    ret = i2c_write_dt(&config->i2c, time_buf, sizeof(time_buf));
+    ret = rv3032_i2c_write(dev, time_buf, sizeof(time_buf));
     if (ret < 0) {
-        LOG_ERR("write block failed");
-        printk("Error writing to RTC\n");
+        LOG_ERR("Error writing to RTC");
         k_mutex_unlock(&data->lock);
         return ret;
     }
@@ -651,7 +699,6 @@ static int rv3032_set_time(const struct device *dev, struct tm *tm)
 static int rv3032_set_alarm(const struct device *dev, 
     const struct rtc_alarm_cfg *alarm_cfg, struct tm *tm, uint32_t mask)
 {
-    const struct rv3032_config *config = (struct rv3032_config *)dev->config;
     struct rv3032_data *data = (struct rv3032_data *)dev->data;
     int ret = 0;
     uint8_t status_register;
@@ -691,83 +738,75 @@ static int rv3032_set_alarm(const struct device *dev,
     WRITE_BIT(hours_alarm, 7, (mask & BIT(1)));
     WRITE_BIT(date_alarm, 7, (mask & BIT(2)));
 
-    printk("RV-3032 minutes_alarm: %u, hours_alarm: %u, date_alarm: %u\n", minutes_alarm, hours_alarm, date_alarm);
+    LOG_DBG("RV-3032 minutes_alarm: %u, hours_alarm: %u, date_alarm: %u", minutes_alarm, hours_alarm, date_alarm);
 
     
     k_mutex_lock(&data->lock, K_FOREVER);
 
     //AIE Alarm Interrupt Enable bit.
     //0 - No interrupt signal is generated on INT̅pin when an Alarm event occurs
-    ret = i2c_reg_read_byte_dt(&config->i2c, RV3032_CONTROL2, &control2_register);
+    ret = rv3032_i2c_reg_read(dev, RV3032_CONTROL2, &control2_register);
     if (ret != 0) {
-        LOG_ERR("read block failed");
-        printk("Error reading AIE\n");
+        LOG_ERR("Error reading AIE");
         k_mutex_unlock(&data->lock);
         return ret;
     }
     
     WRITE_BIT(control2_register, 3, 0);
 
-    i2c_reg_write_byte_dt(&config->i2c, RV3032_CONTROL2, control2_register);
+    rv3032_i2c_reg_write(dev, RV3032_CONTROL2, control2_register);
     if (ret != 0) {
-        LOG_ERR("write block failed");
-        printk("Error writing AIE to RTC\n");
+        LOG_ERR("Error writing AIE to RTC");
         k_mutex_unlock(&data->lock);
         return ret;
     }
 
     //AF status. Alarm Flag. Disable it.
-    ret = i2c_reg_read_byte_dt(&config->i2c, RV3032_STATUS, &status_register);
+    ret = rv3032_i2c_reg_read(dev, RV3032_STATUS, &status_register);
     if (ret != 0) {
-        LOG_ERR("read block failed");
-        printk("Error reading AF\n");
+        LOG_ERR("Error reading AF");
         k_mutex_unlock(&data->lock);
         return ret;
     }
     
     WRITE_BIT(status_register, 3, 0);
 
-    i2c_reg_write_byte_dt(&config->i2c, RV3032_STATUS, status_register);
+    rv3032_i2c_reg_write(dev, RV3032_STATUS, status_register);
     if (ret != 0) {
-        LOG_ERR("write block failed");
-        printk("Error writing AF to RTC\n");
+        LOG_ERR("Error writing AF to RTC");
         k_mutex_unlock(&data->lock);
         return ret;
     }
 
     //write in the Minutes Alarm register
-    i2c_reg_write_byte_dt(&config->i2c, RV3032_MINUTES_ALARM, minutes_alarm);
+    rv3032_i2c_reg_write(dev, RV3032_MINUTES_ALARM, minutes_alarm);
     if (ret != 0) {
-        LOG_ERR("write block failed");
-        printk("Error writing minutes alarm to RTC\n");
+        LOG_ERR("Error writing minutes alarm to RTC");
         k_mutex_unlock(&data->lock);
         return ret;
     }
 
     //write in the Hours Alarm register
-    i2c_reg_write_byte_dt(&config->i2c, RV3032_HOURS_ALARM, hours_alarm);
+    rv3032_i2c_reg_write(dev, RV3032_HOURS_ALARM, hours_alarm);
     if (ret != 0) {
-        LOG_ERR("write block failed");
-        printk("Error writing hours alarm to RTC\n");
+        LOG_ERR("Error writing hours alarm to RTC");
         k_mutex_unlock(&data->lock);
         return ret;
     }
     
     //write in the Date Alarm register
-    i2c_reg_write_byte_dt(&config->i2c, RV3032_DATE_ALARM, date_alarm);
+    rv3032_i2c_reg_write(dev, RV3032_DATE_ALARM, date_alarm);
     if (ret != 0) {
-        LOG_ERR("write block failed");
-        printk("Error writing date alarm to RTC\n");
+        LOG_ERR("Error writing date alarm to RTC");
         k_mutex_unlock(&data->lock);
         return ret;
     }
 
     WRITE_BIT(control2_register, 3, 1);
 
-    i2c_reg_write_byte_dt(&config->i2c, RV3032_CONTROL2, control2_register);
+    rv3032_i2c_reg_write(dev, RV3032_CONTROL2, control2_register);
     if (ret != 0) {
-        LOG_ERR("write block failed");
-        printk("Error writing AIE to RTC\n");
+        LOG_ERR("Error writing AIE to RTC");
         k_mutex_unlock(&data->lock);
         return ret;
     }
@@ -776,14 +815,13 @@ static int rv3032_set_alarm(const struct device *dev,
 
     rv3032_irq_config(dev);
 
-    printk("Alarm has been set in RV-3032\n");
+    LOG_DBG("Alarm has been set in RV-3032");
     return 0;
 }
 
 
 static int rv3032_cancel_alarm(const struct device *dev)
 {
-    const struct rv3032_config *config = (struct rv3032_config *)dev->config;
     struct rv3032_data *data = (struct rv3032_data *)dev->data;
     int ret = 0;
     uint8_t control2_register;
@@ -794,20 +832,18 @@ static int rv3032_cancel_alarm(const struct device *dev)
 
     //AIE Alarm Interrupt Enable bit.
     //0 - No interrupt signal is generated on INT̅pin when an Alarm event occurs
-    ret = i2c_reg_read_byte_dt(&config->i2c, RV3032_CONTROL2, &control2_register);
+    ret = rv3032_i2c_reg_read(dev, RV3032_CONTROL2, &control2_register);
     if (ret != 0) {
-        LOG_ERR("read block failed");
-        printk("Error reading AIE\n");
+        LOG_ERR("Error reading AIE");
         k_mutex_unlock(&data->lock);
         return ret;
     }
     
     WRITE_BIT(control2_register, 3, 0);
 
-    i2c_reg_write_byte_dt(&config->i2c, RV3032_CONTROL2, control2_register);
+    rv3032_i2c_reg_write(dev, RV3032_CONTROL2, control2_register);
     if (ret != 0) {
-        LOG_ERR("write block failed");
-        printk("Error writing AIE to RTC\n");
+        LOG_ERR("Error writing AIE to RTC");
         k_mutex_unlock(&data->lock);
         return ret;
     }
@@ -824,10 +860,14 @@ static void rv3032_int_gpio_callback_handler(const struct device *port,
 
     ARG_UNUSED(pins);
 
-    printk("In ALARM gpio_callback_handler\n");
+    LOG_DBG("In ALARM gpio_callback_handler");
 
+#ifdef CONFIG_MICROCRYSTAL_RV3032_INT_GLOBAL_THREAD
+    k_work_submit(&data->irq_work);
+#else
     //send the semaphore signal to the child thread
     k_sem_give(&data->irq_sem);
+#endif
 }
 
 
@@ -837,27 +877,30 @@ int rv3032_irq_config(const struct device *dev)
     const struct rv3032_config *config = (struct rv3032_config *)dev->config;
     int ret = 0;
 
-    printk("RV-3032 irq config\n");
+    LOG_DBG("RV-3032 irq config");
 
+#ifdef CONFIG_MICROCRYSTAL_RV3032_INT_GLOBAL_THREAD
+    data->dev = dev;
+    k_work_init(&data->irq_work, rv3032_irq_work_handler);
+#else
     k_sem_init(&data->irq_sem, 0, 1);
+#endif
 
     if (config->int_gpio.port != NULL) {
         if (!device_is_ready(config->int_gpio.port)) {
             LOG_ERR("INT GPIO not ready");
-            printk("Interrupt gpio is not ready");
             return -EINVAL;
         }
 
         ret = gpio_pin_configure_dt(&config->int_gpio, GPIO_INPUT | GPIO_ACTIVE_LOW);
         if (ret < 0) {
             LOG_ERR("failed to configure INT GPIO (err %d)", ret);
-            printk("failed to configure INT GPIO (err %d)", ret);
             return ret;
         }
 
         ret = gpio_pin_interrupt_configure_dt(&config->int_gpio, GPIO_INT_EDGE_TO_ACTIVE);
         if (ret < 0) {
-            printk("Error %d: failed to configure interrupt on %s pin %d\n",
+            LOG_ERR("Error %d: failed to configure interrupt on %s pin %d",
                 ret, config->int_gpio.port->name, config->int_gpio.pin);
             return ret;
         }
@@ -869,21 +912,23 @@ int rv3032_irq_config(const struct device *dev)
         ret = gpio_add_callback(config->int_gpio.port, &data->int_gpio_cb);
         if (ret < 0) {
             LOG_ERR("failed to add INT GPIO callback (err %d)", ret);
-            printk("Failed to add Interrupt GPIO callback\n");
             return ret;
         }
 
-        printk("RV-3032 interrupt callback has been set\n");
+        LOG_DBG("RV-3032 interrupt callback has been set");
     } else {
-        printk("The interrupt port for RTC is not set\n");
+        LOG_DBG("The interrupt port for RTC is not set");
     }
 
+#ifndef CONFIG_MICROCRYSTAL_RV3032_INT_GLOBAL_THREAD
     //creates a thread to process an alarm. It gets the signal from the IRQ function.
     k_thread_create(&data->irq_thread, data->irq_thread_stack,
         RV3032_IRQ_THREAD_STACK_SIZE,
         (k_thread_entry_t)rv3032_irq_thread, (void *)dev, NULL, NULL,
         K_PRIO_COOP(2),
         0, K_NO_WAIT);
+    k_thread_name_set(&data->irq_thread, "rv3032_irq");
+#endif
 
     return 0;
 }
@@ -906,23 +951,22 @@ static int rv3032_init(const struct device *dev)
 
     /* Get the I2C device */
     if (!device_is_ready(config->i2c.bus)) {
-        LOG_ERR("Bus device is not ready");
-        printk("RV3032 I2C is not ready");
+        LOG_ERR("RV3032 I2C is not ready");
         return -ENODEV;
     }
 
-    printk("RV-3032 was found\n");
+    LOG_INF("RV-3032 was found");
 
     //read and set the Power Management Unit EEPROM register
     ret = rv3032_eeprom_read(dev, RV3032_EEPROM_PMU, &pmu_register_old);
 
-    printk("PMU %u\n", pmu_register_old);
+    LOG_DBG("PMU %u", pmu_register_old);
 
-    printk("RV-3032 nclke: %u, bsm: %u, tcm: %u, tcr: %u\n", config->nclke, config->bsm, config->tcm, config->tcr);
+    LOG_DBG("RV-3032 nclke: %u, bsm: %u, tcm: %u, tcr: %u", config->nclke, config->bsm, config->tcm, config->tcr);
 
     pmu_register |= config->tcm | (config->tcr << 2) | (config->bsm << 4) | (config->nclke << 6);
 
-    printk("RV-3032 pmu_register: %u\n", pmu_register);
+    LOG_DBG("RV-3032 pmu_register: %u", pmu_register);
 
     if (pmu_register != pmu_register_old) {
         ret = rv3032_eeprom_write(dev, RV3032_EEPROM_PMU, pmu_register);
@@ -979,3 +1023,108 @@ DEVICE_DT_INST_DEFINE(inst, &rv3032_init,                        \
     CONFIG_APPLICATION_INIT_PRIORITY, &rv3032_api);
 
 DT_INST_FOREACH_STATUS_OKAY(RV3032_INIT)
+
+#ifdef CONFIG_MICROCRYSTAL_RV3032_TEMP
+/*
+ * The temperature sensor of the RV-3032 is a child node of the RTC node.
+ * The RTC measures the temperature for its own compensation, so a reading costs one I2C transfer.
+ */
+#undef DT_DRV_COMPAT
+#define DT_DRV_COMPAT microcrystal_rv3032_temp
+
+/**
+ * Reads the temperature registers
+ * @param dev Pointer to the temperature sensor device
+ * @param chan The channel to fetch
+ */
+static int rv3032_temp_sample_fetch(const struct device *dev, enum sensor_channel chan)
+{
+    const struct rv3032_temp_config *temp_config = (const struct rv3032_temp_config *)dev->config;
+    struct rv3032_temp_data *temp_data = (struct rv3032_temp_data *)dev->data;
+    struct rv3032_data *data = (struct rv3032_data *)temp_config->rtc->data;
+    uint8_t temperature_registers[2];
+    int ret;
+
+    if ((chan != SENSOR_CHAN_ALL) && (chan != SENSOR_CHAN_DIE_TEMP)) {
+        return -ENOTSUP;
+    }
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+
+    //TEMP_LSB and TEMP_MSB in one transfer, so both bytes are from the same measurement
+    ret = rv3032_i2c_burst_read(temp_config->rtc, RV3032_TEMP_LSB, temperature_registers, sizeof(temperature_registers));
+
+    k_mutex_unlock(&data->lock);
+
+    if (ret != 0) {
+        LOG_ERR("read temperature failed");
+        return ret;
+    }
+
+    //TEMP_MSB is the signed integer part, TEMP_LSB bits 7:4 are the fraction in 1/16 degree
+    temp_data->temperature = (int16_t)(((int8_t)temperature_registers[1] * 16)
+        | (temperature_registers[0] >> 4));
+
+    return 0;
+}
+
+/**
+ * Converts the temperature to the sensor value
+ * @param dev Pointer to the temperature sensor device
+ * @param chan The channel to get
+ * @param val The temperature in degrees Celsius
+ */
+static int rv3032_temp_channel_get(const struct device *dev, enum sensor_channel chan,
+    struct sensor_value *val)
+{
+    struct rv3032_temp_data *temp_data = (struct rv3032_temp_data *)dev->data;
+
+    if (chan != SENSOR_CHAN_DIE_TEMP) {
+        return -ENOTSUP;
+    }
+
+    //both parts have the same sign
+    val->val1 = temp_data->temperature / 16;
+    val->val2 = (temp_data->temperature % 16) * 62500;
+
+    return 0;
+}
+
+/**
+ * @brief Inits the temperature sensor of the RV-3032
+ *
+ * @param dev Pointer to device structure
+ *
+ * @retval 0 on success else negative errno code.
+ */
+static int rv3032_temp_init(const struct device *dev)
+{
+    const struct rv3032_temp_config *temp_config = (const struct rv3032_temp_config *)dev->config;
+
+    if (!device_is_ready(temp_config->rtc)) {
+        LOG_ERR("RTC device is not ready");
+        return -ENODEV;
+    }
+
+    return 0;
+}
+
+static const struct sensor_driver_api rv3032_temp_api = {
+    .sample_fetch = rv3032_temp_sample_fetch,
+    .channel_get = rv3032_temp_channel_get,
+};
+
+#define RV3032_TEMP_INIT(inst)                                   \
+static struct rv3032_temp_data rv3032_temp_data_ ## inst;        \
+                                                                 \
+static const struct rv3032_temp_config rv3032_temp_config_ ## inst = { \
+    .rtc = DEVICE_DT_GET(DT_INST_PARENT(inst)),                  \
+};                                                               \
+                                                                 \
+DEVICE_DT_INST_DEFINE(inst, &rv3032_temp_init,                   \
+    NULL, &rv3032_temp_data_ ## inst,                            \
+    &rv3032_temp_config_ ## inst, APPLICATION,                   \
+    CONFIG_MICROCRYSTAL_RV3032_TEMP_INIT_PRIORITY, &rv3032_temp_api);
+
+DT_INST_FOREACH_STATUS_OKAY(RV3032_TEMP_INIT)
+#endif /* CONFIG_MICROCRYSTAL_RV3032_TEMP */
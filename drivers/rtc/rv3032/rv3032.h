@@ -13,13 +13,13 @@
 #include <zephyr/device.h>
 #include <zephyr/drivers/i2c.h>
 #include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/sensor.h>
 #include <zephyr/pm/device.h>
-#include <zephyr/sys/printk.h>
 #include <zephyr/sys/util.h>
 #include <soc.h>
 
 #include <zephyr/logging/log.h>
-LOG_MODULE_REGISTER(rv3032, CONFIG_KERNEL_LOG_LEVEL);
+LOG_MODULE_REGISTER(rv3032, CONFIG_MICROCRYSTAL_RV3032_LOG_LEVEL);
 
 #include <driver_rtc.h>
 
@@ -87,10 +87,28 @@ struct rv3032_data {
 #ifdef CONFIG_PM_DEVICE
     uint32_t pm_state;
 #endif
+#ifdef CONFIG_MICROCRYSTAL_RV3032_INT_GLOBAL_THREAD
+    //the system work queue processes interrupts
+    const struct device *dev;
+    struct k_work irq_work;
+#else
     //the thread processes interrupts
     struct k_thread irq_thread;
     struct k_sem irq_sem;
     K_KERNEL_STACK_MEMBER(irq_thread_stack, RV3032_IRQ_THREAD_STACK_SIZE);
+#endif
+};
+
+/** @brief Temperature sensor config data */
+struct rv3032_temp_config {
+    //the parent RTC device
+    const struct device *rtc;
+};
+
+/** @brief Temperature sensor instance data */
+struct rv3032_temp_data {
+    //the last temperature in 1/16 degree Celsius
+    int16_t temperature;
 };
 
 static int rv3032_irq_config(const struct device *dev);
@@ -92,10 +92,10 @@ static int stm32l_rtc_get_time(const struct device *dev, struct tm *tm)
 
     /* Note: need to convert in decimal value in using __LL_RTC_CONVERT_BCD2BIN helper macro */
 
-    printk("rtc_get_time: %.2d:%.2d:%.2d", __LL_RTC_CONVERT_BCD2BIN(LL_RTC_TIME_GetHour(RTC)),
+    LOG_DBG("rtc_get_time: %.2d:%.2d:%.2d, Date: %.2d-%.2d-%.2d", __LL_RTC_CONVERT_BCD2BIN(LL_RTC_TIME_GetHour(RTC)),
           __LL_RTC_CONVERT_BCD2BIN(LL_RTC_TIME_GetMinute(RTC)),
-          __LL_RTC_CONVERT_BCD2BIN(LL_RTC_TIME_GetSecond(RTC)));
-    printk(", Date: %.2d-%.2d-%.2d\n", __LL_RTC_CONVERT_BCD2BIN(LL_RTC_DATE_GetMonth(RTC)),
+          __LL_RTC_CONVERT_BCD2BIN(LL_RTC_TIME_GetSecond(RTC)),
+          __LL_RTC_CONVERT_BCD2BIN(LL_RTC_DATE_GetMonth(RTC)),
           __LL_RTC_CONVERT_BCD2BIN(LL_RTC_DATE_GetDay(RTC)),
           2000 + __LL_RTC_CONVERT_BCD2BIN(LL_RTC_DATE_GetYear(RTC)));
 
@@ -127,7 +127,7 @@ static int stm32l_rtc_set_time(const struct device *dev, struct tm *tm)
 
     z_stm32_hsem_lock(CFG_HW_RCC_SEMID, HSEM_LOCK_DEFAULT_RETRY);
 
-    printk("In rtc_set_time, year: %.2d\n", tm->tm_year);
+    LOG_DBG("In rtc_set_time, year: %.2d", tm->tm_year);
 
     LL_RTC_DisableWriteProtection(RTC);
 
@@ -146,13 +146,11 @@ static int stm32l_rtc_set_time(const struct device *dev, struct tm *tm)
 
     LL_RTC_EnableWriteProtection(RTC);
 
-    printk("In rtc_settime Time: %.2d:%.2d:%.2d", tm->tm_hour, tm->tm_min, tm->tm_sec);
-
-    printk(", Date: %.2d-%.2d-%.2d, Weekday: %.2d\n", tm->tm_year, tm->tm_mon, tm->tm_mday, tm->tm_wday);
+    LOG_DBG("In rtc_settime Time: %.2d:%.2d:%.2d, Date: %.2d-%.2d-%.2d, Weekday: %.2d", tm->tm_hour, tm->tm_min, tm->tm_sec, tm->tm_year, tm->tm_mon, tm->tm_mday, tm->tm_wday);
 
     z_stm32_hsem_unlock(CFG_HW_RCC_SEMID);
 
-    printk("Exited rtc_settime\n");
+    LOG_DBG("Exited rtc_settime");
 
     return 0;
 }
@@ -175,11 +173,11 @@ static int stm32l_rtc_init(const struct device *dev)
     LL_RTC_TimeTypeDef RTC_TimeStruct = {0};
     LL_RTC_DateTypeDef RTC_DateStruct = {0};
 
-    printk("Configuring STM32 RTC\n");
+    LOG_DBG("Configuring STM32 RTC");
 
     z_stm32_hsem_lock(CFG_HW_RCC_SEMID, HSEM_LOCK_DEFAULT_RETRY);
 
-    printk("GRP1\n");
+    LOG_DBG("GRP1");
 
     if (LL_PWR_IsEnabledBkUpAccess () != 1U) {
         // Enable write access to Backup domain
@@ -187,7 +185,7 @@ static int stm32l_rtc_init(const struct device *dev)
         while (LL_PWR_IsEnabledBkUpAccess () == 0U) {}
     }
 
-    printk("BkUpAccess\n");
+    LOG_DBG("BkUpAccess");
 
     //LL_RCC_ForceBackupDomainReset();
     //LL_RCC_ReleaseBackupDomainReset();
@@ -196,19 +194,19 @@ static int stm32l_rtc_init(const struct device *dev)
     LL_RCC_LSE_SetDriveCapability(CONFIG_STM32L_RTC_LSE_DRIVE_STRENGTH);
     LL_RCC_LSE_Enable();
 
-    printk("LSE_ENABLE\n");
+    LOG_DBG("LSE_ENABLE");
 
     // Wait till LSE is ready
     while(LL_RCC_LSE_IsReady() != 1) {}
 
-    printk("LSE_isReady\n");
+    LOG_DBG("LSE_isReady");
 
     LL_RCC_SetRTCClockSource(LL_RCC_RTC_CLKSOURCE_LSE);
-    printk("SetTCCClock\n");
+    LOG_DBG("SetTCCClock");
 
     //it has never been configured
     if (LL_RTC_BAK_GetRegister(RTC, LL_RTC_BKP_DR1) != RTC_BKP_DATE_TIME_UPDATED) {
-        printk("RTC has not been configured");
+        LOG_DBG("RTC has not been configured");
 
         // Peripheral clock enable
         LL_RCC_EnableRTC();
@@ -222,7 +220,7 @@ static int stm32l_rtc_init(const struct device *dev)
         RTC_InitStruct.SynchPrescaler = 255;
         LL_RTC_Init(RTC, &RTC_InitStruct);
 
-        printk("After LL_RTC_Init\n");
+        LOG_DBG("After LL_RTC_Init");
 
         // Initialize RTC and set the Time and Date
         RTC_TimeStruct.Hours = 0x00;
@@ -230,7 +228,7 @@ static int stm32l_rtc_init(const struct device *dev)
         RTC_TimeStruct.Seconds = 0x00;
         LL_RTC_TIME_Init(RTC, LL_RTC_FORMAT_BCD, &RTC_TimeStruct);
 
-        printk("After LL_RTC_TIME_Init\n");
+        LOG_DBG("After LL_RTC_TIME_Init");
 
         RTC_DateStruct.WeekDay = LL_RTC_WEEKDAY_SATURDAY;
         RTC_DateStruct.Month = LL_RTC_MONTH_JANUARY;
@@ -238,7 +236,7 @@ static int stm32l_rtc_init(const struct device *dev)
         RTC_DateStruct.Year = 0x00;
         LL_RTC_DATE_Init(RTC, LL_RTC_FORMAT_BCD, &RTC_DateStruct);
 
-        printk("After LL_RTC_DATE_Init\n");
+        LOG_DBG("After LL_RTC_DATE_Init");
 
         LL_RTC_DisableInitMode(RTC);
         LL_RTC_EnableWriteProtection(RTC);
@@ -249,7 +247,7 @@ static int stm32l_rtc_init(const struct device *dev)
 
     z_stm32_hsem_unlock(CFG_HW_RCC_SEMID);
 
-    printk("After hsem unlock\n");
+    LOG_DBG("After hsem unlock");
 
 #ifdef CONFIG_PM_DEVICE
     data->pm_state = PM_DEVICE_STATE_ACTIVE;
@@ -339,7 +337,7 @@ void stm32_rtc_isr(const struct device *dev)
         }
     }
 
-    printk("After alarm_callback\n");
+    LOG_DBG("After alarm_callback");
 
 #if defined(CONFIG_SOC_SERIES_STM32H7X) && defined(CONFIG_CPU_CORTEX_M4)
     LL_C2_EXTI_ClearFlag_0_31(RTC_EXTI_LINE);
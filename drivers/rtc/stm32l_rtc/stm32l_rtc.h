@@ -12,11 +12,10 @@
 #include <time.h>
 #include <zephyr/device.h>
 #include <zephyr/pm/device.h>
-#include <zephyr/sys/printk.h>
 #include <soc.h>
 
 #include <zephyr/logging/log.h>
-LOG_MODULE_REGISTER(stm32lrtc, CONFIG_KERNEL_LOG_LEVEL);
+LOG_MODULE_REGISTER(stm32lrtc, CONFIG_STM32L_RTC_LOG_LEVEL);
 
 #include <stm32_ll_bus.h>
 #include <stm32_ll_pwr.h>
@@ -15,12 +15,22 @@
 
 LOG_MODULE_REGISTER(veml7700, CONFIG_SENSOR_LOG_LEVEL);
 
+/*
+ * The default does not count the I2C transactions, the application may replace it
+ */
+__weak void veml7700_i2c_transaction(const struct device *dev)
+{
+    ARG_UNUSED(dev);
+}
+
 int veml7700_read(const struct device *dev, uint8_t reg, uint16_t *out)
 {
     const struct veml7700_config *config = dev->config;
     uint8_t buff[2] = { 0 };
     int ret = 0;
 
+    veml7700_i2c_transaction(dev);
+
     ret = i2c_write_read_dt(&config->i2c, &reg, sizeof(reg), buff, sizeof(buff));
 
     if (!ret) {
@@ -45,6 +55,8 @@ int veml7700_write(const struct device *dev, uint8_t reg, uint16_t value)
     msg.flags = 0;
     msg.len = sizeof(buff);
 
+    veml7700_i2c_transaction(dev);
+
     ret = i2c_transfer_dt(&config->i2c, &msg, 1);
 
     if (ret < 0) {
@@ -55,6 +67,144 @@ int veml7700_write(const struct device *dev, uint8_t reg, uint16_t value)
     return 0;
 }
 
+struct veml7700_range {
+    uint8_t als_gain;
+    uint8_t als_it;
+};
+
+/*
+ * The ranges from the least to the most sensitive, as in the Vishay application note
+ * "Designing the VEML7700 Into an Application": the integration time goes down
+ * at the gain 1/8 for the bright light, the gain goes up first and then the integration time for the dark.
+ */
+static const struct veml7700_range veml7700_ranges[] = {
+    {VEML7700_ALS_GAIN_1_8, VEML7700_ALS_IT_25},
+    {VEML7700_ALS_GAIN_1_8, VEML7700_ALS_IT_50},
+    {VEML7700_ALS_GAIN_1_8, VEML7700_ALS_IT_100},
+    {VEML7700_ALS_GAIN_1_4, VEML7700_ALS_IT_100},
+    {VEML7700_ALS_GAIN_1, VEML7700_ALS_IT_100},
+    {VEML7700_ALS_GAIN_2, VEML7700_ALS_IT_100},
+    {VEML7700_ALS_GAIN_2, VEML7700_ALS_IT_200},
+    {VEML7700_ALS_GAIN_2, VEML7700_ALS_IT_400},
+    {VEML7700_ALS_GAIN_2, VEML7700_ALS_IT_800},
+};
+
+// The range the auto ranging starts from
+#define VEML7700_RANGE_START 2
+
+// The gain in 1/8 steps
+static uint8_t veml7700_gain_eighths(uint8_t als_gain)
+{
+    switch (als_gain) {
+    case VEML7700_ALS_GAIN_2:
+        return 16;
+    case VEML7700_ALS_GAIN_1_8:
+        return 1;
+    case VEML7700_ALS_GAIN_1_4:
+        return 2;
+    default:
+        return 8;
+    }
+}
+
+static uint16_t veml7700_it_ms(uint8_t als_it)
+{
+    switch (als_it) {
+    case VEML7700_ALS_IT_25:
+        return 25;
+    case VEML7700_ALS_IT_50:
+        return 50;
+    case VEML7700_ALS_IT_200:
+        return 200;
+    case VEML7700_ALS_IT_400:
+        return 400;
+    case VEML7700_ALS_IT_800:
+        return 800;
+    default:
+        return 100;
+    }
+}
+
+// The wait time between the measurements in the power saving mode 1-4
+static uint16_t veml7700_psm_wait_ms(uint8_t psm)
+{
+    return (psm == 0) ? 0 : (500 << (psm - 1));
+}
+
+// The time between the measurements
+uint32_t veml7700_refresh_ms(struct veml7700_data *data)
+{
+    return veml7700_it_ms(data->als_it) + veml7700_psm_wait_ms(data->psm);
+}
+
+static int veml7700_set_psm(const struct device *dev, uint8_t psm)
+{
+    struct veml7700_data *data = dev->data;
+    uint16_t psm_reg = 0;
+    int ret;
+
+    if (psm > VEML7700_PSM_MODES) {
+        return -EINVAL;
+    }
+
+    if (psm > 0) {
+        psm_reg = ((psm - 1) << VEML7700_PSM_POS) | VEML7700_PSM_EN;
+    }
+
+    ret = veml7700_write(dev, VEML7700_REG_PSM, psm_reg);
+    if (ret < 0) {
+        return ret;
+    }
+
+    data->psm = psm;
+
+    LOG_DBG("PSM: %u", psm);
+
+    return 0;
+}
+
+/*
+ * Writes the gain and the integration time and restarts the conversion,
+ * the caller waits one new integration time for a measurement made with them
+ */
+static int veml7700_set_gain_it(const struct device *dev, uint8_t als_gain, uint8_t als_it)
+{
+    struct veml7700_data *data = dev->data;
+    uint16_t it_ms = veml7700_it_ms(als_it);
+    uint16_t conf = data->conf;
+    int ret;
+
+    conf &= ~(VEML7700_ALS_GAIN_MASK | VEML7700_ALS_IT_MASK);
+    conf |= (als_gain << VEML7700_ALS_GAIN_POS) | (als_it << VEML7700_ALS_IT_POS);
+
+    // The shutdown drops the measurement in progress, it still has the old settings
+    ret = veml7700_write(dev, VEML7700_REG_CONF, conf | VEML7700_ALS_SD_MASK);
+    if (ret < 0) {
+        return ret;
+    }
+
+    ret = veml7700_write(dev, VEML7700_REG_CONF, conf & ~VEML7700_ALS_SD_MASK);
+    if (ret < 0) {
+        return ret;
+    }
+
+    data->conf = conf;
+    data->als_gain = als_gain;
+    data->als_it = als_it;
+    // The resolution scales with the gain and the integration time
+    data->resolution = (uint32_t)VEML7700_RESOLUTION_MAX * 16 * 800 / (veml7700_gain_eighths(als_gain) * it_ms);
+
+#ifdef CONFIG_VEML7700_TRIGGER
+    // The threshold registers are in counts
+    ret = veml7700_write_thresholds(dev);
+    if (ret < 0) {
+        return ret;
+    }
+#endif
+
+    return 0;
+}
+
 static int veml7700_sample_fetch(const struct device *dev,
             enum sensor_channel chan)
 {
@@ -68,7 +218,60 @@ static int veml7700_sample_fetch(const struct device *dev,
     if (chan == SENSOR_CHAN_ALL || chan == SENSOR_CHAN_LIGHT) {
         ret = veml7700_read(dev, VEML7700_REG_ALS_DATA, &data->light);
 
-    printk("Light level: %u\n", data->light);
+#ifdef CONFIG_VEML7700_AUTO_RANGE
+        uint8_t psm = data->psm;
+        uint32_t waited_ms = 0;
+
+        // The neighbour ranges differ at most 4 times, so the count stays between the limits after a step
+        for (uint8_t i = 0; (ret == 0) && (i < ARRAY_SIZE(veml7700_ranges)); i++) {
+            uint8_t range = data->range;
+
+            if ((data->light > VEML7700_RANGE_HIGH_COUNTS) && (range > 0)) {
+                range--;
+            } else if ((data->light < VEML7700_RANGE_LOW_COUNTS) && (range < (ARRAY_SIZE(veml7700_ranges) - 1))) {
+                range++;
+            } else {
+                break;
+            }
+
+            uint16_t wait_ms = veml7700_it_ms(veml7700_ranges[range].als_it) + VEML7700_RANGE_IT_MARGIN_MS;
+
+            // The auto ranging time is bounded, the next fetch goes on from this range
+            if ((waited_ms + wait_ms) > VEML7700_RANGE_MAX_MS) {
+                LOG_DBG("Auto ranging stopped at the range %u", data->range);
+                break;
+            }
+
+            // The power saving wait is not needed between the steps, the restarted conversion does not wait
+            if (data->psm != 0) {
+                ret = veml7700_set_psm(dev, 0);
+                if (ret < 0) {
+                    break;
+                }
+            }
+
+            ret = veml7700_set_gain_it(dev, veml7700_ranges[range].als_gain, veml7700_ranges[range].als_it);
+            if (ret == 0) {
+                // The first measurement after the restart has the new gain and integration time
+                k_msleep(wait_ms);
+                waited_ms += wait_ms;
+
+                data->range = range;
+                ret = veml7700_read(dev, VEML7700_REG_ALS_DATA, &data->light);
+            }
+        }
+
+        // The power saving mode is restored after the auto ranging
+        if (data->psm != psm) {
+            int psm_ret = veml7700_set_psm(dev, psm);
+
+            if (ret == 0) {
+                ret = psm_ret;
+            }
+        }
+#endif
+
+    LOG_DBG("Light level: %u, gain: %u, it: %u", data->light, data->als_gain, data->als_it);
         if (ret < 0) {
             LOG_ERR("Could not fetch ambient light");
         }
@@ -85,11 +288,22 @@ static int veml7700_channel_get(const struct device *dev,
 {
     struct veml7700_data *data = dev->data;
     int ret = 0;
+    uint64_t micro_lux;
 
     switch (chan) {
         case SENSOR_CHAN_LIGHT:
-            val->val1 = data->light;
-            val->val2 = 0;
+            micro_lux = (uint64_t)data->light * data->resolution;
+
+            // The non-linearity correction from the application note for the low gains
+            if ((data->als_gain == VEML7700_ALS_GAIN_1_8) || (data->als_gain == VEML7700_ALS_GAIN_1_4)) {
+                float lux = (float)micro_lux / 1000000.0f;
+
+                lux = (((6.0135e-13f * lux - 9.3924e-9f) * lux + 8.1488e-5f) * lux + 1.0023f) * lux;
+                micro_lux = (uint64_t)(lux * 1000000.0f);
+            }
+
+            val->val1 = micro_lux / 1000000;
+            val->val2 = micro_lux % 1000000;
         break;
 
     default:
@@ -99,6 +313,57 @@ static int veml7700_channel_get(const struct device *dev,
     return ret;
 }
 
+static int veml7700_attr_get(const struct device *dev,
+                enum sensor_channel chan,
+                enum sensor_attribute attr,
+                struct sensor_value *val)
+{
+    struct veml7700_data *data = dev->data;
+    uint32_t refresh_ms = veml7700_refresh_ms(data);
+
+    if (chan != SENSOR_CHAN_LIGHT) {
+        return -ENOTSUP;
+    }
+
+    switch ((int)attr) {
+    case SENSOR_ATTR_SAMPLING_FREQUENCY:
+        // A new measurement is ready after the integration time and the power saving wait
+        val->val1 = 1000 / refresh_ms;
+        val->val2 = ((uint64_t)1000000000 / refresh_ms) % 1000000;
+        break;
+    case SENSOR_ATTR_VEML7700_PSM:
+        val->val1 = data->psm;
+        val->val2 = 0;
+        break;
+    default:
+        return -ENOTSUP;
+    }
+
+    return 0;
+}
+
+static int veml7700_attr_set(const struct device *dev,
+                enum sensor_channel chan,
+                enum sensor_attribute attr,
+                const struct sensor_value *val)
+{
+    if (chan != SENSOR_CHAN_LIGHT) {
+        return -ENOTSUP;
+    }
+
+    switch ((int)attr) {
+    case SENSOR_ATTR_VEML7700_PSM:
+        return veml7700_set_psm(dev, val->val1);
+#ifdef CONFIG_VEML7700_TRIGGER
+    case SENSOR_ATTR_UPPER_THRESH:
+    case SENSOR_ATTR_LOWER_THRESH:
+        return veml7700_threshold_set(dev, attr, val);
+#endif
+    default:
+        return -ENOTSUP;
+    }
+}
+
 #ifdef CONFIG_PM_DEVICE
 static int veml7700_pm_action(const struct device *dev,
           enum pm_device_action action)
@@ -151,6 +416,7 @@ static int veml7700_pm_action(const struct device *dev,
 static int veml7700_init(const struct device *dev)
 {
     const struct veml7700_config *config = dev->config;
+    struct veml7700_data *data = dev->data;
     uint16_t conf = 0;
 
     uint16_t tmp, tmp1 = 0;
@@ -172,51 +438,80 @@ static int veml7700_init(const struct device *dev)
 
     tmp = conf;
 
-    printk("Config VEML7700: %u\n", tmp);
-
-    printk("ALS gain: %u\n", config->als_gain);
-    printk("ALS it: %u\n", config->als_it);
-    printk("ALS pers: %u\n", config->als_pers);
-    printk("PSM: %u\n", config->psm);
+    LOG_DBG("Config VEML7700: %u", tmp);
+
+    LOG_DBG("ALS gain: %u", config->als_gain);
+    LOG_DBG("ALS it: %u", config->als_it);
+    LOG_DBG("ALS pers: %u", config->als_pers);
+    LOG_DBG("PSM: %u", config->psm);
+
+#ifdef CONFIG_VEML7700_AUTO_RANGE
+    // The devicetree gain and integration time are replaced by the start range
+    data->range = VEML7700_RANGE_START;
+    data->als_gain = veml7700_ranges[VEML7700_RANGE_START].als_gain;
+    data->als_it = veml7700_ranges[VEML7700_RANGE_START].als_it;
+#else
+    data->als_gain = config->als_gain;
+    data->als_it = config->als_it;
+#endif
+    data->resolution = (uint32_t)VEML7700_RESOLUTION_MAX * 16 * 800
+        / (veml7700_gain_eighths(data->als_gain) * veml7700_it_ms(data->als_it));
 
     // Set ALS gain
-    conf |= config->als_gain << VEML7700_ALS_GAIN_POS;
+    conf |= data->als_gain << VEML7700_ALS_GAIN_POS;
 
     tmp = conf;
-    printk("Config after gain: %u\n", tmp);
+    LOG_DBG("Config after gain: %u", tmp);
     
     // Set ALS integration time
-    conf |= config->als_it << VEML7700_ALS_IT_POS;
+    conf |= data->als_it << VEML7700_ALS_IT_POS;
     tmp = conf;
 
-    printk("Config after integration: %u\n", tmp);
+    LOG_DBG("Config after integration: %u", tmp);
 
     // Set ALS persistence protect number 
     conf |= config->als_pers << VEML7700_ALS_PERS_POS;
 
     tmp = conf;
 
-    printk("Config after persistance: %u\n", tmp);
+    LOG_DBG("Config after persistance: %u", tmp);
 
     // Clear ALS shutdown
     conf &= ~VEML7700_ALS_SD_MASK;
     tmp1 = conf;
 
-    printk("Config after shutdown clear: %u\n", tmp1);
+    LOG_DBG("Config after shutdown clear: %u", tmp1);
 
     if (veml7700_write(dev, VEML7700_REG_CONF, conf)) {
         LOG_ERR("Could not write config");
-        printk("Could not write config");
         return -EIO;
     }
 
+    data->conf = conf;
+
+    if (veml7700_set_psm(dev, config->psm_enable ? (config->psm + 1) : 0)) {
+        LOG_ERR("Could not write the power saving mode");
+        return -EIO;
+    }
+
+#ifdef CONFIG_VEML7700_TRIGGER
+    if (veml7700_init_interrupt(dev) < 0) {
+        LOG_ERR("Could not init the trigger");
+        return -EIO;
+    }
+#endif
+
     LOG_DBG("Init complete");
-    printk("Init complete");
 
     return 0;
 }
 
 static const struct sensor_driver_api veml7700_driver_api = {
+    .attr_set = veml7700_attr_set,
+    .attr_get = veml7700_attr_get,
+#ifdef CONFIG_VEML7700_TRIGGER
+    .trigger_set = veml7700_trigger_set,
+#endif
     .sample_fetch = veml7700_sample_fetch,
     .channel_get = veml7700_channel_get,
 };
@@ -228,6 +523,7 @@ static const struct veml7700_config veml7700_config_ ## inst = {   \
     .als_it = DT_INST_PROP(inst, als_it),                          \
     .als_pers = DT_INST_PROP(inst, als_pers),                      \
     .psm = DT_INST_PROP(inst, psm),                                \
+    .psm_enable = DT_INST_PROP(inst, psm_enable),                  \
 };                                                                 \
                                                                    \
 static struct veml7700_data veml7700_data_ ## inst;                \
@@ -11,6 +11,8 @@
 #include <zephyr/drivers/i2c.h>
 #include <zephyr/pm/device.h>
 
+#include <driver_veml7700.h>
+
 // The slave address (7 bit) is set to 0010000 = 0x10.
 // The least significant bit (LSB) defines read or write mode.
 // Accordingly, for 8 bit the bus address is then 0010 0000 = 20h for write and 0010 0001 = 21h for read
@@ -20,8 +22,27 @@
 #define VEML7700_REG_CONF 0x00
 // ALS High Resolution Output Data register
 #define VEML7700_REG_ALS_DATA 0x04
+// ALS high threshold window setting register
+#define VEML7700_REG_ALS_WH 0x01
+// ALS low threshold window setting register
+#define VEML7700_REG_ALS_WL 0x02
 // Power Saving Mode register
 #define VEML7700_REG_PSM 0x03
+// ALS interrupt status register, reading it clears the flags
+#define VEML7700_REG_ALS_INT 0x06
+
+// The power saving mode enable bit in the PSM register
+#define VEML7700_PSM_EN BIT(0)
+
+// The position of the power saving mode in the PSM register
+#define VEML7700_PSM_POS 1
+
+// The ALS interrupt enable bit in the config register
+#define VEML7700_ALS_INT_EN BIT(1)
+
+// The threshold crossing flags in the interrupt status register
+#define VEML7700_ALS_INT_TH_HIGH BIT(14)
+#define VEML7700_ALS_INT_TH_LOW BIT(15)
 
 // The position of ALS gain in the config register
 #define VEML7700_ALS_GAIN_POS 11
@@ -35,6 +56,39 @@
 // ALS shutdown bit is 0
 #define VEML7700_ALS_SD_MASK BIT(0)
 
+// The ALS gain and integration time bits in the config register
+#define VEML7700_ALS_GAIN_MASK (0x03 << VEML7700_ALS_GAIN_POS)
+#define VEML7700_ALS_IT_MASK (0x0f << VEML7700_ALS_IT_POS)
+
+// The ALS gain codes
+#define VEML7700_ALS_GAIN_1 0x00
+#define VEML7700_ALS_GAIN_2 0x01
+#define VEML7700_ALS_GAIN_1_8 0x02
+#define VEML7700_ALS_GAIN_1_4 0x03
+
+// The ALS integration time codes
+#define VEML7700_ALS_IT_25 0x0c
+#define VEML7700_ALS_IT_50 0x08
+#define VEML7700_ALS_IT_100 0x00
+#define VEML7700_ALS_IT_200 0x01
+#define VEML7700_ALS_IT_400 0x02
+#define VEML7700_ALS_IT_800 0x03
+
+// The resolution in micro lux per count at the gain 2 and the integration time 800 ms
+#define VEML7700_RESOLUTION_MAX 3600
+
+// The auto ranging moves to a less sensitive range above this count
+#define VEML7700_RANGE_HIGH_COUNTS 10000
+
+// The auto ranging moves to a more sensitive range below this count
+#define VEML7700_RANGE_LOW_COUNTS 100
+
+// The wait after the integration time for the measurement with the new range, it covers the wake-up from the shutdown, ms
+#define VEML7700_RANGE_IT_MARGIN_MS 10
+
+// The longest time of the auto ranging in one fetch, ms
+#define VEML7700_RANGE_MAX_MS 2000
+
 struct veml7700_config {
     struct i2c_dt_spec i2c;
     // Ambient light sensor gain selection
@@ -45,14 +99,51 @@ struct veml7700_config {
     uint8_t als_pers;
     // Power saving mode
     uint8_t psm;
+    // Power saving mode is enabled at init
+    bool psm_enable;
 };
 
 struct veml7700_data {
     struct k_sem sem;
     uint16_t light;
+    // The config register value
+    uint16_t conf;
+    // The ALS gain and integration time codes in use
+    uint8_t als_gain;
+    uint8_t als_it;
+    // The index in the auto ranging table
+    uint8_t range;
+    // Micro lux per count at the current gain and integration time
+    uint32_t resolution;
+    // The power saving mode 1-4, 0 if it is disabled
+    uint8_t psm;
+#ifdef CONFIG_VEML7700_TRIGGER
+    const struct device *dev;
+    // Checks the interrupt status register
+    struct k_work_delayable trigger_work;
+    sensor_trigger_handler_t threshold_handler;
+    struct sensor_trigger threshold_trigger;
+    // The threshold window in milli lux, the registers are in counts of the current range
+    uint32_t threshold_low;
+    uint32_t threshold_high;
+#endif
 };
 
 int veml7700_read(const struct device *dev, uint8_t reg, uint16_t *out);
 int veml7700_write(const struct device *dev, uint8_t reg, uint16_t value);
 
+uint32_t veml7700_refresh_ms(struct veml7700_data *data);
+
+#ifdef CONFIG_VEML7700_TRIGGER
+int veml7700_threshold_set(const struct device *dev, enum sensor_attribute attr,
+    const struct sensor_value *val);
+
+int veml7700_trigger_set(const struct device *dev, const struct sensor_trigger *trig,
+    sensor_trigger_handler_t handler);
+
+int veml7700_init_interrupt(const struct device *dev);
+
+int veml7700_write_thresholds(const struct device *dev);
+#endif
+
 #endif
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2022 Farit N
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define DT_DRV_COMPAT vishay_veml7700
+
+#include "veml7700.h"
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(veml7700, CONFIG_SENSOR_LOG_LEVEL);
+
+/*
+ * A threshold is armed when there is a handler and the window is narrower than all the values
+ */
+static bool veml7700_threshold_armed(struct veml7700_data *data)
+{
+    return (data->threshold_handler != NULL)
+        && ((data->threshold_low > 0) || (data->threshold_high < UINT32_MAX));
+}
+
+/*
+ * Schedules the next status check. The chip compares only a new measurement,
+ * so the status is not checked more often than the measurements are made.
+ */
+static void veml7700_trigger_schedule(struct veml7700_data *data)
+{
+    if (!veml7700_threshold_armed(data)) {
+        return;
+    }
+
+    k_work_schedule(&data->trigger_work,
+        K_MSEC(MAX(CONFIG_VEML7700_TRIGGER_POLL_INTERVAL, veml7700_refresh_ms(data))));
+}
+
+/*
+ * The VEML7700 has no interrupt pin. When ALS_INT_EN is set, the chip compares every
+ * measurement with the threshold window and latches the crossing in the ALS_INT register,
+ * so the work reads only that register.
+ */
+static void veml7700_trigger_work_handler(struct k_work *work)
+{
+    struct k_work_delayable *delayable = k_work_delayable_from_work(work);
+    struct veml7700_data *data = CONTAINER_OF(delayable, struct veml7700_data, trigger_work);
+    uint16_t status = 0;
+
+    if (!veml7700_threshold_armed(data)) {
+        return;
+    }
+
+    if (veml7700_read(data->dev, VEML7700_REG_ALS_INT, &status) < 0) {
+        LOG_ERR("Could not read the interrupt status");
+    } else if (status & (VEML7700_ALS_INT_TH_HIGH | VEML7700_ALS_INT_TH_LOW)) {
+        data->threshold_handler(data->dev, &data->threshold_trigger);
+    }
+
+    veml7700_trigger_schedule(data);
+}
+
+/*
+ * Converts the threshold to counts of the current range.
+ * The chip compares the raw counts, so the non-linearity correction is not applied.
+ */
+static uint16_t veml7700_threshold_counts(const struct device *dev, uint32_t milli_lux)
+{
+    struct veml7700_data *data = dev->data;
+    uint64_t counts = (uint64_t)milli_lux * 1000 / data->resolution;
+
+    return MIN(counts, UINT16_MAX);
+}
+
+int veml7700_write_thresholds(const struct device *dev)
+{
+    struct veml7700_data *data = dev->data;
+    int ret;
+
+    ret = veml7700_write(dev, VEML7700_REG_ALS_WH, veml7700_threshold_counts(dev, data->threshold_high));
+    if (ret < 0) {
+        return ret;
+    }
+
+    return veml7700_write(dev, VEML7700_REG_ALS_WL, veml7700_threshold_counts(dev, data->threshold_low));
+}
+
+int veml7700_threshold_set(const struct device *dev, enum sensor_attribute attr,
+    const struct sensor_value *val)
+{
+    struct veml7700_data *data = dev->data;
+    uint32_t milli_lux;
+    int ret;
+
+    // The thresholds are in lux
+    milli_lux = CLAMP(val->val1, 0, UINT32_MAX / 1000) * 1000 + CLAMP(val->val2, 0, 999999) / 1000;
+
+    switch (attr) {
+    case SENSOR_ATTR_UPPER_THRESH:
+        data->threshold_high = milli_lux;
+        ret = veml7700_write(dev, VEML7700_REG_ALS_WH, veml7700_threshold_counts(dev, milli_lux));
+        break;
+    case SENSOR_ATTR_LOWER_THRESH:
+        data->threshold_low = milli_lux;
+        ret = veml7700_write(dev, VEML7700_REG_ALS_WL, veml7700_threshold_counts(dev, milli_lux));
+        break;
+    default:
+        return -ENOTSUP;
+    }
+
+    // The polling starts when the window is armed, a running poll keeps its time
+    if ((ret == 0) && !k_work_delayable_is_pending(&data->trigger_work)) {
+        veml7700_trigger_schedule(data);
+    }
+
+    return ret;
+}
+
+int veml7700_trigger_set(const struct device *dev, const struct sensor_trigger *trig,
+    sensor_trigger_handler_t handler)
+{
+    struct veml7700_data *data = dev->data;
+    uint16_t status;
+    int ret;
+
+    if ((trig->type != SENSOR_TRIG_THRESHOLD) || (trig->chan != SENSOR_CHAN_LIGHT)) {
+        return -ENOTSUP;
+    }
+
+    k_work_cancel_delayable(&data->trigger_work);
+
+    data->threshold_handler = handler;
+    data->threshold_trigger = *trig;
+
+    if (handler != NULL) {
+        data->conf |= VEML7700_ALS_INT_EN;
+    } else {
+        data->conf &= ~VEML7700_ALS_INT_EN;
+    }
+
+    ret = veml7700_write(dev, VEML7700_REG_CONF, data->conf);
+    if (ret < 0) {
+        return ret;
+    }
+
+    //clear the flags left from the previous window
+    veml7700_read(dev, VEML7700_REG_ALS_INT, &status);
+
+    veml7700_trigger_schedule(data);
+
+    return 0;
+}
+
+int veml7700_init_interrupt(const struct device *dev)
+{
+    struct veml7700_data *data = dev->data;
+
+    data->dev = dev;
+    data->threshold_handler = NULL;
+    data->threshold_low = 0;
+    data->threshold_high = UINT32_MAX;
+
+    k_work_init_delayable(&data->trigger_work, veml7700_trigger_work_handler);
+
+    return 0;
+}